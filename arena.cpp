@@ -0,0 +1,56 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdint>
+
+void arena::add_chunk(std::size_t min_size) {
+    // chunks at least double, so a run needs few of them before the first reset merges them
+    auto size = std::max(min_size, m_min_chunk_size);
+    if (!m_chunks.empty()) size = std::max(size, 2 * m_chunks.back().size);
+
+    m_chunks.push_back(chunk{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    m_offset = 0;
+}
+
+void *arena::allocate(std::size_t bytes, std::size_t alignment) {
+    if (bytes == 0) bytes = 1;
+
+    auto fits = [&]() {
+        if (m_chunks.empty()) return false;
+
+        auto address = reinterpret_cast<std::uintptr_t>(m_chunks.back().data.get()) + m_offset;
+        auto padding = (alignment - address % alignment) % alignment;
+
+        return m_offset + padding + bytes <= m_chunks.back().size;
+    };
+
+    // a new chunk starts aligned to max_align_t, the extra alignment covers stricter requests
+    if (!fits()) add_chunk(bytes + alignment);
+
+    auto &current = m_chunks.back();
+    auto address = reinterpret_cast<std::uintptr_t>(current.data.get()) + m_offset;
+    auto padding = (alignment - address % alignment) % alignment;
+
+    m_offset += padding + bytes;
+    m_used += padding + bytes;
+
+    return current.data.get() + (m_offset - bytes);
+}
+
+void arena::reset() {
+    if (m_chunks.size() > 1 || (!m_chunks.empty() && m_chunks.back().size < m_used)) {
+        // the slack covers padding which differs once all allocations share a chunk
+        auto size = m_used + m_used / 8;
+
+        m_chunks.clear();
+        add_chunk(size);
+    }
+
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t arena::capacity() const {
+    std::size_t total = 0;
+    for (auto const &c : m_chunks) total += c.size;
+    return total;
+}
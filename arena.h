@@ -0,0 +1,107 @@
+#ifndef MINIMUM_SPANNING_TREE_ARENA_H
+#define MINIMUM_SPANNING_TREE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Monotonic memory arena for the scratch buffers of a computation.
+ *
+ * Memory is handed out by bumping a pointer through large chunks and is never freed one allocation at a time;
+ * reset() releases everything at once. A reset arena keeps a single chunk big enough for all the memory used
+ * since the previous reset, so repeating a computation of the same size does not touch the heap at all.
+ * Not thread-safe: the buffers may be used by many threads, but only one thread may allocate.
+ */
+class arena {
+    struct chunk {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<chunk> m_chunks{};
+    std::size_t m_offset{0};            // first free byte of the last chunk
+    std::size_t m_used{0};              // bytes handed out since the last reset, including padding
+    std::size_t m_min_chunk_size;
+
+    void add_chunk(std::size_t min_size);
+
+public:
+    /**
+     * @param min_chunk_size Size of the first chunk, which is allocated on the first allocation
+     */
+    explicit arena(std::size_t min_chunk_size = std::size_t{1} << 16) : m_min_chunk_size{min_chunk_size} {}
+
+    arena(arena const &) = delete;
+    arena &operator=(arena const &) = delete;
+
+    /**
+     * Allocates uninitialized memory valid until the next reset
+     * @param bytes Size of the block
+     * @param alignment Alignment of the block, a power of two
+     * @return The block
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Allocates an array of default-initialized elements valid until the next reset.
+     * The elements are never destroyed, so the type has to be trivially destructible.
+     * @param n Number of elements
+     * @return The array
+     */
+    template<typename T>
+    T *allocate_array(std::size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena arrays are never destroyed");
+
+        auto data = static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+        for (std::size_t i = 0; i < n; i++) new(data + i) T;
+
+        return data;
+    }
+
+    /**
+     * Invalidates all allocations. Keeps one chunk which fits everything used since the previous reset.
+     */
+    void reset();
+
+    inline std::size_t used() const { return m_used; }
+
+    std::size_t capacity() const;
+};
+
+/**
+ * Standard allocator drawing from an arena, so containers can keep their scratch memory in it.
+ * Deallocation does nothing; containers using it should reserve their final size up front.
+ */
+template<typename T>
+class arena_allocator {
+    template<typename U> friend class arena_allocator;
+
+    arena *m_arena;
+
+public:
+    typedef T value_type;
+
+    explicit arena_allocator(arena &a) : m_arena{&a} {}
+
+    template<typename U>
+    arena_allocator(arena_allocator<U> const &other) : m_arena{other.m_arena} {}
+
+    inline T *allocate(std::size_t n) { return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+    inline void deallocate(T *, std::size_t) {}
+
+    inline arena &source() const { return *m_arena; }
+
+    template<typename U>
+    inline bool operator==(arena_allocator<U> const &other) const { return m_arena == other.m_arena; }
+
+    template<typename U>
+    inline bool operator!=(arena_allocator<U> const &other) const { return m_arena != other.m_arena; }
+};
+
+template<typename T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+
+#endif //MINIMUM_SPANNING_TREE_ARENA_H
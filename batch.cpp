@@ -0,0 +1,226 @@
+#include "batch.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "arena.h"
+#include "graph_file.h"
+#include "mst_cache.h"
+#include "mst_engine.h"
+#include "thread_pool.h"
+
+namespace {
+    typedef std::chrono::steady_clock batch_clock;
+
+    inline double ms_between(batch_clock::time_point from, batch_clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    /**
+     * Job read from the request stream
+     */
+    struct batch_job {
+        std::size_t index;
+        std::string input;
+        std::string output;
+        batch_clock::time_point received;
+    };
+
+    /**
+     * Measurements of a finished job
+     */
+    struct job_result {
+        std::size_t vertices{0};
+        std::size_t edges{0};
+        unsigned long long weight{0};
+        double load_ms{0};
+        double solve_ms{0};
+        double write_ms{0};
+        double latency_ms{0};
+        bool cached{false};
+        std::string error{};
+    };
+
+    /**
+     * Parses a request line
+     * @return False if the line holds no job
+     */
+    bool parse_job(std::string const &line, batch_job &job) {
+        auto blanks = " \t\r";
+        auto begin = line.find_first_not_of(blanks);
+        if (begin == std::string::npos || line[begin] == '#') return false;
+
+        auto end = line.find_first_of(blanks, begin);
+        job.input = line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+
+        auto output = end == std::string::npos ? std::string::npos : line.find_first_not_of(blanks, end);
+        if (output == std::string::npos) {
+            job.output = job.input + ".mst";
+        } else {
+            auto output_end = line.find_first_of(blanks, output);
+            job.output = line.substr(output, output_end == std::string::npos ? std::string::npos : output_end - output);
+        }
+
+        return true;
+    }
+
+    job_result solve_job(batch_job const &job, batch_options const &options, mst_cache const *cache, arena &scratch) {
+        job_result result{};
+
+        try {
+            auto started = batch_clock::now();
+            auto g = is_binary_graph_file(job.input) ? load_binary_graph(job.input)
+                                                     : load_text_graph(job.input, nullptr);
+            auto loaded = batch_clock::now();
+
+            graph_fingerprint key{};
+            edge_ids_t tree;
+            if (cache != nullptr) {
+                key = fingerprint_graph(g, nullptr);
+                result.cached = cache->lookup(g, key, tree) &&
+                                (options.forest || tree.size() + 1 >= g.vertex_count());
+            }
+
+            if (!result.cached) {
+                auto engine = options.algorithm == "auto" ? choose_mst_engine(g, false)
+                                                          : make_mst_engine(options.algorithm);
+                if (engine == nullptr) throw std::invalid_argument("Unknown algorithm " + options.algorithm);
+
+                engine->set_scratch(&scratch);
+                engine->set_spanning_forest(options.forest);
+
+                tree = engine->solve(g, nullptr);
+            }
+            auto solved = batch_clock::now();
+
+            write_result(g, tree, job.output, options.format);
+            if (cache != nullptr && !result.cached) {
+                // the MST is saved already, so a full or read-only cache does not fail the job
+                try {
+                    cache->store(g, key, tree);
+                } catch (std::runtime_error const &) {}
+            }
+            auto written = batch_clock::now();
+
+            result.vertices = g.vertex_count();
+            result.edges = g.edge_count();
+            for (auto e : tree) result.weight += g.weights()[e];
+            result.load_ms = ms_between(started, loaded);
+            result.solve_ms = ms_between(loaded, solved);
+            result.write_ms = ms_between(solved, written);
+        } catch (std::exception const &error) {
+            result.error = error.what();
+        }
+
+        result.latency_ms = ms_between(job.received, batch_clock::now());
+
+        return result;
+    }
+
+    void write_report_line(std::ostream &report, batch_job const &job, job_result const &r) {
+        report << job.index << '\t' << job.input << '\t' << job.output << '\t'
+               << (!r.error.empty() ? "failed" : r.cached ? "cached" : "ok")
+               << '\t' << r.vertices << '\t' << r.edges << '\t' << r.weight << '\t' << r.load_ms << '\t'
+               << r.solve_ms << '\t' << r.write_ms << '\t' << r.latency_ms << '\t' << r.error << '\n';
+    }
+
+    double percentile(std::vector<double> const &sorted, double p) {
+        if (sorted.empty()) return 0;
+
+        auto rank = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+}
+
+batch_summary run_batch(std::istream &requests, std::ostream &report, batch_options const &options, thread_pool &pool) {
+    // every slot is a task of the pool which keeps taking jobs until the requests end, so a slot beyond
+    // the size of the pool would only start once the others are done
+    auto slot_count = std::max<std::size_t>(1, pool.size());
+    if (options.concurrency > 0) slot_count = std::min(slot_count, options.concurrency);
+
+    std::unique_ptr<mst_cache> cache;
+    if (!options.cache.empty()) cache = std::make_unique<mst_cache>(options.cache, options.cache_limit);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<batch_job> queue;
+    auto closed = false;
+    std::size_t running = slot_count;
+    std::vector<double> latencies;
+    batch_summary summary{0, 0, 0, 0, 0, 0, 0};
+
+    report << "job\tinput\toutput\tstatus\tvertices\tedges\tweight\tload_ms\tsolve_ms\twrite_ms\tlatency_ms\terror\n";
+    report.flush();
+
+    auto started = batch_clock::now();
+
+    for (std::size_t s = 0; s < slot_count; s++) {
+        pool.submit([&]() {
+            arena scratch;
+
+            while (true) {
+                batch_job job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return closed || !queue.empty(); });
+
+                    if (queue.empty()) break;
+
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                }
+                changed.notify_all();
+
+                auto result = solve_job(job, options, cache.get(), scratch);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                write_report_line(report, job, result);
+                report.flush();
+
+                latencies.push_back(result.latency_ms);
+                if (result.error.empty()) {
+                    summary.edges += result.edges;
+                } else {
+                    ++summary.failed;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            changed.notify_all();
+        });
+    }
+
+    // the queue holds at most one job per slot, so a request stream is read only as fast as the jobs are solved
+    std::string line;
+    while (std::getline(requests, line)) {
+        batch_job job{summary.jobs, {}, {}, batch_clock::now()};
+        if (!parse_job(line, job)) continue;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return queue.size() < slot_count; });
+
+        queue.push_back(std::move(job));
+        ++summary.jobs;
+        changed.notify_all();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    changed.notify_all();
+    changed.wait(lock, [&running] { return running == 0; });
+
+    summary.wall_ms = ms_between(started, batch_clock::now());
+
+    std::sort(latencies.begin(), latencies.end());
+    summary.median_latency_ms = percentile(latencies, 0.5);
+    summary.p95_latency_ms = percentile(latencies, 0.95);
+    summary.max_latency_ms = latencies.empty() ? 0 : latencies.back();
+
+    return summary;
+}
@@ -0,0 +1,63 @@
+#ifndef MINIMUM_SPANNING_TREE_BATCH_H
+#define MINIMUM_SPANNING_TREE_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "result_writer.h"
+
+class thread_pool;
+
+/**
+ * Settings shared by all jobs of a batch
+ */
+struct batch_options {
+    std::string algorithm{"auto"};  // engine name or auto, see choose_mst_engine()
+    result_format format{result_format::adjacency};
+    bool forest{false};             // see mst_engine::set_spanning_forest()
+    std::size_t concurrency{0};     // jobs solved at once, at most and by default the size of the pool
+    std::string cache{};            // directory of an mst_cache shared by the jobs, empty for none
+    std::uint64_t cache_limit{std::uint64_t{1} << 30};
+};
+
+/**
+ * Totals of a batch
+ */
+struct batch_summary {
+    std::size_t jobs;
+    std::size_t failed;
+    std::size_t edges;              // of the input graphs of the solved jobs
+    double wall_ms;
+    double median_latency_ms;
+    double p95_latency_ms;
+    double max_latency_ms;
+};
+
+/**
+ * Solves the MSTs of many graphs in one process.
+ *
+ * Every line of the request stream is a job "<input> [<output>]", the output defaults to the input path
+ * with ".mst" appended; blank lines and lines starting with # are skipped. Every job slot is a task of the pool
+ * taking the jobs in the order they are read until the stream ends, and the stream is read only as fast as
+ * the slots take the jobs, so a stream of requests (e.g. the standard input) is served while it is still being
+ * written. Every slot keeps its scratch arena for all of its jobs, so after the first few jobs the engines
+ * allocate nothing.
+ *
+ * A job loads its graph, text or binary, solves it in a single thread and writes the MST; many jobs share
+ * the pool, not one job. As soon as a job finishes, a tab-separated line
+ * "<job> <input> <output> <status> <vertices> <edges> <weight> <load ms> <solve ms> <write ms> <latency ms> <error>"
+ * is written to the report, preceded by a header line. The latency is measured from the moment the job is read.
+ * With a cache, a job whose graph has an MST there saves that one with the status "cached" instead of "ok",
+ * and a computed MST is stored.
+ * A failed job (unreadable input, disconnected graph without the forest option) does not stop the batch.
+ * @param requests Request stream
+ * @param report Receives the report lines
+ * @param options Settings of the jobs
+ * @param pool Pool running the jobs
+ * @return Totals of the batch
+ */
+batch_summary run_batch(std::istream &requests, std::ostream &report, batch_options const &options, thread_pool &pool);
+
+#endif //MINIMUM_SPANNING_TREE_BATCH_H
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "arena.h"
+#include "cheapest_edge_kernel.h"
+#include "graph_generator.h"
+#include "mst_engine.h"
+#include "thread_pool.h"
+
+/**
+ * Options of the benchmark, see print_help()
+ */
+struct benchmark_options {
+    std::vector<std::string> families{"random", "grid", "power-law", "complete"};
+    std::vector<std::string> engines{"boruvka", "contracting-boruvka", "kruskal", "filter-kruskal", "prim"};
+    std::vector<std::size_t> sizes{100000, 1000000};
+    std::vector<std::size_t> threads{0, thread_pool::default_thread_count()};
+    std::size_t degree{8};
+    weight_t max_weight{1000};
+    std::uint64_t seed{42};
+    std::size_t repetitions{5};
+    std::size_t warmup{1};
+    std::string format{"json"};
+    std::string output{};
+};
+
+/**
+ * Measurements of one engine on one graph with one thread count
+ */
+struct benchmark_result {
+    std::string family;
+    std::size_t vertex_count;
+    std::size_t edge_count;
+    std::string engine;
+    std::size_t threads;
+    std::size_t repetitions;
+    double median_ms;
+    double p95_ms;
+    double min_ms;
+    double edges_per_second;
+    weight_t mst_weight;
+    long peak_rss_kib;
+};
+
+void print_help() {
+    std::cout << "\n\nUsage: ./mst_benchmark [<options>]\n" << std::endl
+              << "--families=<list>\t Graph families: random, grid, power-law, complete (default: all)" << std::endl
+              << "--engines=<list>\t MST engines: boruvka, contracting-boruvka, kruskal, filter-kruskal, prim (default: all)" << std::endl
+              << "--sizes=<list>\t\t Edge counts of the generated graphs (default: 100000,1000000)" << std::endl
+              << "--threads=<list>\t Pool sizes, 0 runs in the calling thread (default: 0,<hardware concurrency>)"
+              << std::endl
+              << "--degree=<n>\t\t Average degree of the random and power-law graphs (default: 8)" << std::endl
+              << "--max-weight=<n>\t Edge weights are drawn from [1, n] (default: 1000)" << std::endl
+              << "--seed=<n>\t\t Seed of the graph generator (default: 42)" << std::endl
+              << "--repetitions=<n>\t Measured runs per configuration (default: 5)" << std::endl
+              << "--warmup=<n>\t\t Unmeasured runs before the measured ones (default: 1)" << std::endl
+              << "--simd=<level>\t\t Cheapest-edge kernel of Borůvka: scalar, avx2 or avx512 (default: the best supported)"
+              << std::endl
+              << "--format=<f>\t\t Report format: json (default) or csv" << std::endl
+              << "--output=<file>\t\t Report file instead of the standard output" << std::endl
+              << "\nAll lists are comma-separated. Progress is printed to the standard error." << std::endl;
+}
+
+bool read_option(std::string const &arg, std::string const &name, std::string &value) {
+    if (arg.size() <= name.size() || arg.compare(0, name.size(), name) != 0 || arg[name.size()] != '=')
+        return false;
+
+    value = arg.substr(name.size() + 1);
+    return true;
+}
+
+std::vector<std::string> split_list(std::string const &list) {
+    std::vector<std::string> items;
+    std::stringstream stream{list};
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+        if (!item.empty()) items.push_back(item);
+
+    return items;
+}
+
+std::vector<std::size_t> split_numbers(std::string const &list) {
+    std::vector<std::size_t> numbers;
+    for (auto const &item : split_list(list)) numbers.push_back(std::stoul(item));
+    return numbers;
+}
+
+/**
+ * Starts a new peak of the resident set size, which Linux supports since 4.0. The peak of the process
+ * would include every configuration measured before.
+ * @return False if the peak cannot be reset
+ */
+bool reset_peak_rss() {
+#if defined(__GLIBC__)
+    // the heap freed by the graphs and runs before is returned first, or it would count as resident
+    malloc_trim(0);
+#endif
+#if defined(__linux__)
+    std::ofstream clear_refs{"/proc/self/clear_refs"};
+    clear_refs << "5" << std::flush;
+    return static_cast<bool>(clear_refs);
+#else
+    return false;
+#endif
+}
+
+/**
+ * @return Peak resident set size since reset_peak_rss() in KiB, or -1 if it cannot be measured
+ */
+long peak_rss_kib() {
+#if defined(__linux__)
+    std::ifstream status{"/proc/self/status"};
+    std::string line;
+
+    while (std::getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::stol(line.substr(6));
+#endif
+    return -1;
+}
+
+/**
+ * @param sorted Sorted samples
+ * @param q Quantile in [0, 1]
+ * @return Nearest-rank quantile of the samples
+ */
+double quantile(std::vector<double> const &sorted, double q) {
+    auto rank = static_cast<std::size_t>(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+double median(std::vector<double> const &sorted) {
+    auto middle = sorted.size() / 2;
+    return sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+/**
+ * Runs one engine on one graph repeatedly
+ * @param pool Pool passed to the engine, nullptr runs it in the calling thread
+ * @return The measurements
+ */
+benchmark_result run_benchmark(benchmark_options const &options, std::string const &family, csr_graph const &g,
+                               mst_engine const &engine, thread_pool *pool) {
+    edge_ids_t tree;
+    auto rss_reset = reset_peak_rss();
+
+    for (std::size_t i = 0; i < options.warmup; i++) tree = engine.solve(g, pool);
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+
+    for (std::size_t i = 0; i < options.repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        tree = engine.solve(g, pool);
+        auto end = std::chrono::steady_clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    weight_t mst_weight = 0;
+    for (auto e : tree) mst_weight += g.weights()[e];
+
+    benchmark_result result{};
+    result.family = family;
+    result.vertex_count = g.vertex_count();
+    result.edge_count = g.edge_count();
+    result.engine = engine.name();
+    result.threads = pool != nullptr ? pool->size() : 0;
+    result.repetitions = samples.size();
+    result.median_ms = median(samples);
+    result.p95_ms = quantile(samples, 0.95);
+    result.min_ms = samples.front();
+    result.edges_per_second = result.median_ms > 0 ? g.edge_count() / (result.median_ms / 1000) : 0;
+    result.mst_weight = mst_weight;
+    result.peak_rss_kib = rss_reset ? peak_rss_kib() : -1;
+
+    return result;
+}
+
+void write_json(std::ostream &out, std::vector<benchmark_result> const &results) {
+    out << std::fixed << std::setprecision(3) << "[" << std::endl;
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        auto const &r = results[i];
+
+        out << "  {\"family\": \"" << r.family << "\", \"vertices\": " << r.vertex_count
+            << ", \"edges\": " << r.edge_count << ", \"engine\": \"" << r.engine << "\", \"threads\": " << r.threads
+            << ", \"repetitions\": " << r.repetitions << ", \"median_ms\": " << r.median_ms
+            << ", \"p95_ms\": " << r.p95_ms << ", \"min_ms\": " << r.min_ms
+            << ", \"edges_per_second\": " << std::setprecision(0) << r.edges_per_second << std::setprecision(3)
+            << ", \"mst_weight\": " << r.mst_weight << ", \"peak_rss_kib\": " << r.peak_rss_kib << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    out << "]" << std::endl;
+}
+
+void write_csv(std::ostream &out, std::vector<benchmark_result> const &results) {
+    out << std::fixed << std::setprecision(3)
+        << "family,vertices,edges,engine,threads,repetitions,median_ms,p95_ms,min_ms,edges_per_second,"
+           "mst_weight,peak_rss_kib" << std::endl;
+
+    for (auto const &r : results) {
+        out << r.family << ',' << r.vertex_count << ',' << r.edge_count << ',' << r.engine << ',' << r.threads << ','
+            << r.repetitions << ',' << r.median_ms << ',' << r.p95_ms << ',' << r.min_ms << ','
+            << std::setprecision(0) << r.edges_per_second << std::setprecision(3) << ','
+            << r.mst_weight << ',' << r.peak_rss_kib << std::endl;
+    }
+}
+
+/**
+ * Parses the program arguments
+ * @return False if an argument is invalid, the reason is printed
+ */
+bool parse_options(int argc, char *argv[], benchmark_options &options) {
+    for (int i = 1; i < argc; i++) {
+        auto current = std::string(argv[i]);
+        std::string value;
+
+        try {
+            if (read_option(current, "--families", value)) {
+                options.families = split_list(value);
+            } else if (read_option(current, "--engines", value)) {
+                options.engines = split_list(value);
+            } else if (read_option(current, "--sizes", value)) {
+                options.sizes = split_numbers(value);
+            } else if (read_option(current, "--threads", value)) {
+                options.threads = split_numbers(value);
+            } else if (read_option(current, "--degree", value)) {
+                options.degree = std::stoul(value);
+            } else if (read_option(current, "--max-weight", value)) {
+                options.max_weight = std::stoul(value);
+            } else if (read_option(current, "--seed", value)) {
+                options.seed = std::stoull(value);
+            } else if (read_option(current, "--repetitions", value)) {
+                options.repetitions = std::max<std::size_t>(1, std::stoul(value));
+            } else if (read_option(current, "--warmup", value)) {
+                options.warmup = std::stoul(value);
+            } else if (read_option(current, "--simd", value)) {
+                simd_level level;
+                if (!parse_simd_level(value, level)) {
+                    std::cerr << "Unknown SIMD level " << value << std::endl;
+                    return false;
+                }
+                if (!set_simd_level(level)) {
+                    std::cerr << "The processor does not support " << value << std::endl;
+                    return false;
+                }
+            } else if (read_option(current, "--format", value)) {
+                if (value != "json" && value != "csv") {
+                    std::cerr << "Unknown report format " << value << std::endl;
+                    return false;
+                }
+                options.format = value;
+            } else if (read_option(current, "--output", value)) {
+                options.output = value;
+            } else {
+                std::cerr << "Unknown argument " << current << std::endl;
+                return false;
+            }
+        } catch (std::logic_error const &) {
+            std::cerr << "Invalid value of " << current << std::endl;
+            return false;
+        }
+    }
+
+    for (auto const &name : options.families) {
+        graph_family family;
+        if (!parse_graph_family(name, family)) {
+            std::cerr << "Unknown graph family " << name << std::endl;
+            return false;
+        }
+    }
+
+    for (auto const &name : options.engines) {
+        if (make_mst_engine(name) == nullptr) {
+            std::cerr << "Unknown algorithm " << name << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    benchmark_options options{};
+
+    if (argc == 2 && std::string(argv[1]) == "--help") {
+        print_help();
+        return 0;
+    }
+
+    if (!parse_options(argc, argv, options)) return 1;
+
+    std::cerr << "Cheapest-edge kernel: " << to_string(active_simd_level()) << std::endl;
+
+    // pools are started once per size, so the thread start-up is not measured
+    std::map<std::size_t, std::unique_ptr<thread_pool>> pools;
+    for (auto threads : options.threads)
+        if (threads != 0 && pools.count(threads) == 0) pools[threads] = std::make_unique<thread_pool>(threads);
+
+    std::vector<benchmark_result> results;
+
+    // all runs share one scratch arena, so only the first run of the largest size allocates its buffers
+    arena scratch;
+
+    for (auto const &name : options.families) {
+        graph_family family;
+        parse_graph_family(name, family);
+
+        for (auto size : options.sizes) {
+            std::cerr << "Generating " << name << " graph with about " << size << " edges." << std::endl;
+
+            auto g = generate_graph(family, size, options.degree, options.max_weight, options.seed);
+
+            for (auto const &engine_name : options.engines) {
+                auto engine = make_mst_engine(engine_name);
+                engine->set_scratch(&scratch);
+
+                for (auto threads : options.threads) {
+                    auto pool = threads == 0 ? nullptr : pools[threads].get();
+                    auto result = run_benchmark(options, name, g, *engine, pool);
+
+                    std::cerr << "  " << std::left << std::setw(15) << engine_name << std::right
+                              << " threads " << std::setw(3) << threads << ": median " << std::fixed
+                              << std::setprecision(3) << result.median_ms << " ms, p95 " << result.p95_ms << " ms"
+                              << std::endl;
+
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output, std::ios::out | std::ios::trunc);
+
+        if (!file) {
+            std::cerr << "Cannot open " << options.output << std::endl;
+            return 1;
+        }
+    }
+
+    auto &out = options.output.empty() ? std::cout : file;
+
+    if (options.format == "csv")
+        write_csv(out, results);
+    else
+        write_json(out, results);
+
+    return 0;
+}
@@ -0,0 +1,367 @@
+#include "boruvka.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include "cheapest_edge_kernel.h"
+
+namespace {
+    const std::uint64_t no_key = UINT64_MAX;
+
+    /**
+     * Blocks shorter than this are not worth a separate task
+     */
+    const std::size_t min_block_size = 4096;
+
+    /**
+     * Average degree from which scanning the adjacency slots with the SIMD kernel beats the edge list:
+     * sparser graphs give the kernel too few slots per vertex and read every live edge twice
+     */
+    const std::size_t min_slot_degree = 32;
+
+    /**
+     * Lowers the target to value if value is less, retrying the compare-and-swap while other threads race it
+     */
+    template<typename Less>
+    inline void atomic_min(std::atomic<std::uint64_t> &target, std::uint64_t value, Less const &less) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (less(value, current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+}
+
+boruvka_engine::boruvka_engine(csr_graph const &g, arena *scratch)
+        : m_graph{g},
+          m_scratch{scratch != nullptr ? *scratch : m_own_scratch},
+          m_sets{g.vertex_count(), arena_allocator<union_find::id_t>(m_scratch)},
+          m_labels(g.vertex_count(), arena_allocator<csr_graph::vertex_id>(m_scratch)),
+          m_cheapest(g.vertex_count(), csr_graph::no_edge, arena_allocator<csr_graph::edge_id>(m_scratch)) {
+    for (std::size_t v = 0; v < m_labels.size(); v++) m_labels[v] = static_cast<csr_graph::vertex_id>(v);
+}
+
+std::vector<csr_graph::edge_id> boruvka_engine::run() {
+    if (slots_usable()) return run_slots(nullptr);
+
+    auto sources = m_graph.sources();
+    auto targets = m_graph.targets();
+
+    arena_vector<csr_graph::edge_id> active(m_graph.edge_count(), arena_allocator<csr_graph::edge_id>(m_scratch));
+    for (std::size_t e = 0; e < active.size(); e++) active[e] = static_cast<csr_graph::edge_id>(e);
+
+    m_tree.reserve(m_graph.vertex_count());
+    if (m_trace != nullptr) m_trace->set_threads(0);
+
+    while (m_sets.set_count() > 1) {
+        boruvka_trace::clock::time_point phases[4];
+        auto components = m_sets.set_count();
+        auto scanned = active.size();
+        std::size_t kept = 0;
+
+        phases[0] = boruvka_trace::clock::now();
+
+        // searches for the cheapest edge of each component, dropping edges inside a component for good
+        for (auto e : active) {
+            auto a = m_labels[sources[e]], b = m_labels[targets[e]];
+            if (a == b) continue;
+
+            active[kept++] = e;
+
+            if (m_cheapest[a] == csr_graph::no_edge || m_graph.lighter(e, m_cheapest[a])) m_cheapest[a] = e;
+            if (m_cheapest[b] == csr_graph::no_edge || m_graph.lighter(e, m_cheapest[b])) m_cheapest[b] = e;
+        }
+
+        active.resize(kept);
+        phases[1] = boruvka_trace::clock::now();
+
+        auto added = commit_cheapest_edges();
+        phases[2] = boruvka_trace::clock::now();
+
+        if (added > 0) relabel();
+        phases[3] = boruvka_trace::clock::now();
+
+        trace_round(components, scanned, kept, added, phases, {}, nullptr);
+
+        if (added == 0) break; // no edge leaves any component, the graph is not connected
+    }
+
+    check_spanning();
+
+    return std::move(m_tree);
+}
+
+std::vector<csr_graph::edge_id> boruvka_engine::run_parallel(thread_pool &pool) {
+    if (slots_usable()) return run_slots(&pool);
+
+    auto vertex_count = m_graph.vertex_count();
+    auto edge_count = m_graph.edge_count();
+    auto sources = m_graph.sources();
+    auto targets = m_graph.targets();
+    auto weights = m_graph.weights();
+
+    // weights which fit into 32 bits are packed with the edge id into a single key, so the best edge of
+    // a component is a plain atomic minimum; heavier weights fall back to comparing through the edge arrays
+    auto max_weight = edge_count > 0 ? *std::max_element(weights, weights + edge_count) : 0;
+    auto packed = max_weight <= UINT32_MAX;
+
+    auto best = m_scratch.allocate_array<std::atomic<std::uint64_t>>(vertex_count);
+    for (std::size_t c = 0; c < vertex_count; c++) best[c].store(no_key, std::memory_order_relaxed);
+
+    // the edges are scanned in fixed blocks, each block keeps its remaining inter-component edges at its front
+    auto block_count = std::max<std::size_t>(1, std::min(edge_count / min_block_size, 8 * pool.size()));
+    auto block_length = (edge_count + block_count - 1) / block_count;
+
+    arena_vector<csr_graph::edge_id> active(edge_count, arena_allocator<csr_graph::edge_id>(m_scratch));
+    arena_vector<std::size_t> block_sizes(block_count, arena_allocator<std::size_t>(m_scratch));
+
+    for (std::size_t e = 0; e < edge_count; e++) active[e] = static_cast<csr_graph::edge_id>(e);
+    for (std::size_t i = 0; i < block_count; i++)
+        block_sizes[i] = std::min(edge_count, (i + 1) * block_length) - std::min(edge_count, i * block_length);
+
+    m_tree.reserve(vertex_count);
+    if (m_trace != nullptr) m_trace->set_threads(pool.size());
+    thread_pool::recording recording{m_trace != nullptr ? &pool : nullptr};
+
+    while (m_sets.set_count() > 1) {
+        boruvka_trace::clock::time_point phases[4];
+        auto components = m_sets.set_count();
+        auto before = m_trace != nullptr ? pool.activity() : std::vector<worker_activity>();
+
+        std::size_t scanned = 0;
+        for (auto size : block_sizes) scanned += size;
+
+        phases[0] = boruvka_trace::clock::now();
+
+        // balances the work by edge count: the blocks are independent of the component sizes
+        pool.parallel_for(0, block_count, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto block = begin; block < end; block++) {
+                auto first = active.data() + block * block_length;
+                std::size_t kept = 0;
+
+                for (std::size_t i = 0; i < block_sizes[block]; i++) {
+                    auto e = first[i];
+                    auto a = m_labels[sources[e]], b = m_labels[targets[e]];
+                    if (a == b) continue;
+
+                    first[kept++] = e;
+
+                    if (packed) {
+                        auto key = (static_cast<std::uint64_t>(weights[e]) << 32) | e;
+                        atomic_min(best[a], key, std::less<std::uint64_t>());
+                        atomic_min(best[b], key, std::less<std::uint64_t>());
+                    } else {
+                        auto lighter = [this](std::uint64_t x, std::uint64_t y) {
+                            return y == no_key || m_graph.lighter(static_cast<csr_graph::edge_id>(x),
+                                                                  static_cast<csr_graph::edge_id>(y));
+                        };
+                        atomic_min(best[a], e, lighter);
+                        atomic_min(best[b], e, lighter);
+                    }
+                }
+
+                block_sizes[block] = kept;
+            }
+        });
+
+        phases[1] = boruvka_trace::clock::now();
+
+        for (std::size_t c = 0; c < vertex_count; c++) {
+            auto key = best[c].load(std::memory_order_relaxed);
+            if (key == no_key) continue;
+
+            m_cheapest[c] = static_cast<csr_graph::edge_id>(key & UINT32_MAX);
+            best[c].store(no_key, std::memory_order_relaxed);
+        }
+
+        auto added = commit_cheapest_edges();
+        phases[2] = boruvka_trace::clock::now();
+
+        if (added > 0) relabel(pool);
+        phases[3] = boruvka_trace::clock::now();
+
+        if (m_trace != nullptr) {
+            std::size_t kept = 0;
+            for (auto size : block_sizes) kept += size;
+
+            trace_round(components, scanned, kept, added, phases, before, &pool);
+        }
+
+        if (added == 0) break; // no edge leaves any component, the graph is not connected
+    }
+
+    check_spanning();
+
+    return std::move(m_tree);
+}
+
+bool boruvka_engine::slots_usable() const {
+    auto weights = m_graph.weights();
+    auto edge_count = m_graph.edge_count();
+
+    return m_graph.vertex_count() <= INT32_MAX
+           && 2 * edge_count >= min_slot_degree * m_graph.vertex_count()
+           && std::all_of(weights, weights + edge_count, [](weight_t w) { return w <= UINT32_MAX; });
+}
+
+std::vector<csr_graph::edge_id> boruvka_engine::run_slots(thread_pool *pool) {
+    auto vertex_count = m_graph.vertex_count();
+    auto offsets = m_graph.offsets();
+    auto neighbors = m_graph.neighbors();
+    auto neighbor_weights = m_graph.neighbor_weights();
+    auto neighbor_edges = m_graph.neighbor_edges();
+    auto slot_count = offsets[vertex_count];
+
+    adjacency_slots slots{offsets,
+                          m_scratch.allocate_array<std::uint32_t>(vertex_count),
+                          m_scratch.allocate_array<csr_graph::vertex_id>(slot_count),
+                          m_scratch.allocate_array<std::uint64_t>(slot_count)};
+    auto vertex_keys = m_scratch.allocate_array<std::uint64_t>(vertex_count);
+    auto best = m_scratch.allocate_array<std::atomic<std::uint64_t>>(vertex_count);
+
+    auto copy_slots = [&](std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++) {
+            slots.counts[v] = static_cast<std::uint32_t>(offsets[v + 1] - offsets[v]);
+            best[v].store(no_key, std::memory_order_relaxed);
+
+            for (auto slot = offsets[v]; slot < offsets[v + 1]; slot++) {
+                slots.targets[slot] = neighbors[slot];
+                slots.keys[slot] = (static_cast<std::uint64_t>(neighbor_weights[slot]) << 32) | neighbor_edges[slot];
+            }
+        }
+    };
+
+    if (pool != nullptr) {
+        pool->parallel_for(0, vertex_count, 0, copy_slots);
+    } else {
+        copy_slots(0, vertex_count);
+    }
+
+    // every live edge has a slot at both of its endpoints, and both slots are dropped in the same round
+    auto live = slot_count;
+
+    m_tree.reserve(vertex_count);
+    if (m_trace != nullptr) m_trace->set_threads(pool != nullptr ? pool->size() : 0);
+    thread_pool::recording recording{m_trace != nullptr ? pool : nullptr};
+
+    while (m_sets.set_count() > 1) {
+        boruvka_trace::clock::time_point phases[4];
+        auto components = m_sets.set_count();
+        auto before = m_trace != nullptr && pool != nullptr ? pool->activity() : std::vector<worker_activity>();
+        auto scanned = live / 2;
+        std::atomic<std::size_t> remaining{0};
+
+        phases[0] = boruvka_trace::clock::now();
+
+        // the kernel finds the cheapest edge of every vertex, only these minima race for their component
+        auto search = [&](std::size_t begin, std::size_t end) {
+            remaining.fetch_add(cheapest_leaving_edges(slots, m_labels.data(), begin, end, vertex_keys),
+                                std::memory_order_relaxed);
+
+            for (auto v = begin; v < end; v++)
+                if (vertex_keys[v] != no_key) atomic_min(best[m_labels[v]], vertex_keys[v], std::less<std::uint64_t>());
+        };
+
+        if (pool != nullptr) {
+            pool->parallel_for(0, vertex_count, 0, search);
+        } else {
+            search(0, vertex_count);
+        }
+
+        live = remaining.load();
+        phases[1] = boruvka_trace::clock::now();
+
+        for (std::size_t c = 0; c < vertex_count; c++) {
+            auto key = best[c].load(std::memory_order_relaxed);
+            if (key == no_key) continue;
+
+            m_cheapest[c] = static_cast<csr_graph::edge_id>(key & UINT32_MAX);
+            best[c].store(no_key, std::memory_order_relaxed);
+        }
+
+        auto added = commit_cheapest_edges();
+        phases[2] = boruvka_trace::clock::now();
+
+        if (added > 0) {
+            if (pool != nullptr) {
+                relabel(*pool);
+            } else {
+                relabel();
+            }
+        }
+        phases[3] = boruvka_trace::clock::now();
+
+        trace_round(components, scanned, live / 2, added, phases, before, pool);
+
+        if (added == 0) break; // no edge leaves any component, the graph is not connected
+    }
+
+    check_spanning();
+
+    return std::move(m_tree);
+}
+
+std::size_t boruvka_engine::commit_cheapest_edges() {
+    auto sources = m_graph.sources();
+    auto targets = m_graph.targets();
+    std::size_t added = 0;
+
+    for (std::size_t c = 0; c < m_cheapest.size(); c++) {
+        auto e = m_cheapest[c];
+        if (e == csr_graph::no_edge) continue;
+
+        // both components may have picked the same edge, the union-find filters the duplicate out
+        if (m_sets.unite(sources[e], targets[e])) {
+            m_tree.push_back(e);
+            ++added;
+        }
+
+        m_cheapest[c] = csr_graph::no_edge;
+    }
+
+    if (m_sink != nullptr && added > 0) (*m_sink)(m_tree.data() + m_tree.size() - added, added);
+
+    return added;
+}
+
+void boruvka_engine::relabel() {
+    for (std::size_t v = 0; v < m_labels.size(); v++)
+        m_labels[v] = m_sets.find(static_cast<union_find::id_t>(v));
+}
+
+void boruvka_engine::relabel(thread_pool &pool) {
+    pool.parallel_for(0, m_labels.size(), 0, [this](std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++)
+            m_labels[v] = m_sets.find_root(static_cast<union_find::id_t>(v));
+    });
+}
+
+void boruvka_engine::trace_round(std::size_t components, std::size_t scanned, std::size_t kept, std::size_t added,
+                                 boruvka_trace::clock::time_point const (&phases)[4],
+                                 std::vector<worker_activity> const &before, thread_pool *pool) {
+    if (m_trace == nullptr) return;
+
+    auto us = [](boruvka_trace::clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+
+    boruvka_round round{};
+    round.components = components;
+    round.edges_scanned = scanned;
+    round.edges_filtered = scanned - kept;
+    round.edges_added = added;
+    round.search_start_us = m_trace->since_start(phases[0]);
+    round.search_us = us(phases[1] - phases[0]);
+    round.commit_us = us(phases[2] - phases[1]);
+    round.relabel_us = us(phases[3] - phases[2]);
+
+    if (pool != nullptr) {
+        round.activity = pool->activity();
+
+        for (std::size_t t = 0; t < round.activity.size() && t < before.size(); t++) {
+            round.activity[t].tasks -= before[t].tasks;
+            round.activity[t].busy_ns -= before[t].busy_ns;
+        }
+    }
+
+    m_trace->add_round(round);
+}
+
+void boruvka_engine::check_spanning() const {
+    if (!m_forest && m_sets.set_count() > 1) throw std::domain_error("MST could not be found!");
+}
@@ -0,0 +1,118 @@
+#ifndef MINIMUM_SPANNING_TREE_BORUVKA_H
+#define MINIMUM_SPANNING_TREE_BORUVKA_H
+
+#include <vector>
+#include "arena.h"
+#include "boruvka_trace.h"
+#include "csr_graph.h"
+#include "mst_engine.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+/**
+ * Borůvka's algorithm over a CSR graph.
+ *
+ * Components are kept in a disjoint-set forest for the whole run and identified by the integer label
+ * of their representative. After every round each vertex is relabeled to its representative, so the
+ * cheapest-edge search compares two integers per edge. Edges found to be inside a component are
+ * dropped for good, so every round scans only the edges that may still join components.
+ *
+ * On dense graphs with weights fitting into 32 bits, the search runs over a copy of the adjacency arrays
+ * with the (weight, id) of every edge packed into one key, using the SIMD kernel of cheapest_edge_kernel.h:
+ * every vertex finds its cheapest leaving edge without any shared writes, and only the per-vertex minima
+ * are combined per component. Other graphs are searched by scanning an active edge list.
+ * All buffers are allocated once, before the first round, from the scratch arena of the engine.
+ */
+class boruvka_engine {
+    csr_graph const &m_graph;
+    arena m_own_scratch{};
+    arena &m_scratch;
+    arena_union_find m_sets;
+    arena_vector<csr_graph::vertex_id> m_labels;
+    arena_vector<csr_graph::edge_id> m_cheapest;
+    std::vector<csr_graph::edge_id> m_tree{};
+    boruvka_trace *m_trace{nullptr};
+    bool m_forest{false};
+    tree_sink_t const *m_sink{nullptr};
+
+    /**
+     * Records a round if the engine is traced
+     * @param phases Start of the search, end of the search, end of the commit and end of the relabeling
+     * @param before Activity of the pool at the start of the round, empty for serial runs
+     * @param pool Pool of a parallel run or nullptr
+     */
+    void trace_round(std::size_t components, std::size_t scanned, std::size_t kept, std::size_t added,
+                     boruvka_trace::clock::time_point const (&phases)[4],
+                     std::vector<worker_activity> const &before, thread_pool *pool);
+
+    /**
+     * @return True if the search can run over packed adjacency slots, see run_slots()
+     */
+    bool slots_usable() const;
+
+    /**
+     * Computes the MST with the cheapest-edge search running over the adjacency slots
+     * @param pool Pool executing the search, nullptr searches in the calling thread
+     * @return Ids of the MST edges
+     */
+    std::vector<csr_graph::edge_id> run_slots(thread_pool *pool);
+
+    /**
+     * Adds the cheapest edge of every component to the tree and merges the components it joins.
+     * Passes the added edges to the sink and resets the cheapest edges for the next round.
+     * @return Number of edges added to the tree
+     */
+    std::size_t commit_cheapest_edges();
+
+    /**
+     * Points every vertex to the representative of its component.
+     */
+    void relabel();
+    void relabel(thread_pool &pool);
+
+    /**
+     * Throws std::domain_error if the tree does not span the whole graph, unless a forest was asked for.
+     */
+    void check_spanning() const;
+
+public:
+    /**
+     * @param g CSR graph
+     * @param scratch Arena for the buffers of the run, which has to outlive the engine;
+     *                nullptr makes the engine use an arena of its own
+     */
+    explicit boruvka_engine(csr_graph const &g, arena *scratch = nullptr);
+
+    /**
+     * Makes the engine record every round of the next run
+     * @param trace Receives the rounds, nullptr stops the recording
+     */
+    inline void set_trace(boruvka_trace *trace) { m_trace = trace; }
+
+    /**
+     * Makes the runs return the minimum spanning forest of a disconnected graph instead of throwing
+     */
+    inline void set_spanning_forest(bool forest) { m_forest = forest; }
+
+    /**
+     * Makes the runs pass the edges committed in every round to a sink
+     * @param sink The sink, which has to outlive the runs, nullptr for none
+     */
+    inline void set_tree_sink(tree_sink_t const *sink) { m_sink = sink; }
+
+    /**
+     * Computes the MST in a single thread
+     * @return Ids of the MST edges
+     */
+    std::vector<csr_graph::edge_id> run();
+
+    /**
+     * Computes the MST in parallel. The edge array is scanned in chunks and every inter-component edge
+     * lowers the best edge of both of its components with a lock-free atomic minimum.
+     * @param pool Pool executing the search
+     * @return Ids of the MST edges
+     */
+    std::vector<csr_graph::edge_id> run_parallel(thread_pool &pool);
+};
+
+#endif //MINIMUM_SPANNING_TREE_BORUVKA_H
@@ -0,0 +1,101 @@
+#include "boruvka_trace.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+    void write_event(std::ostream &out, bool &first, std::string const &name, double start, double duration,
+                     std::string const &args) {
+        out << (first ? "" : ",\n") << "  {\"name\": \"" << name << "\", \"cat\": \"boruvka\", \"ph\": \"X\", "
+            << "\"pid\": 1, \"tid\": 0, \"ts\": " << start << ", \"dur\": " << duration
+            << ", \"args\": {" << args << "}}";
+        first = false;
+    }
+}
+
+void boruvka_trace::write_chrome_trace(std::ostream &out) const {
+    auto first = true;
+
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [\n";
+
+    for (std::size_t r = 0; r < m_rounds.size(); r++) {
+        auto const &round = m_rounds[r];
+        auto round_args = "\"round\": " + std::to_string(r + 1);
+
+        auto search_end = round.search_start_us + round.search_us;
+        auto commit_end = search_end + round.commit_us;
+        auto total = round.search_us + round.commit_us + round.relabel_us;
+
+        write_event(out, first, "round " + std::to_string(r + 1), round.search_start_us, total,
+                    round_args + ", \"components\": " + std::to_string(round.components));
+        write_event(out, first, "search", round.search_start_us, round.search_us,
+                    round_args + ", \"scanned\": " + std::to_string(round.edges_scanned) +
+                    ", \"filtered\": " + std::to_string(round.edges_filtered));
+        write_event(out, first, "commit", search_end, round.commit_us,
+                    round_args + ", \"added\": " + std::to_string(round.edges_added));
+        write_event(out, first, "relabel", commit_end, round.relabel_us, round_args);
+
+        // busy milliseconds of every thread, shown as a counter track per thread
+        for (std::size_t t = 0; t < round.activity.size(); t++) {
+            auto name = t + 1 == round.activity.size() ? std::string("caller") : "worker " + std::to_string(t);
+
+            out << ",\n  {\"name\": \"busy ms: " << name << "\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+                << round.search_start_us << ", \"args\": {\"busy\": " << round.activity[t].busy_ns / 1e6
+                << ", \"tasks\": " << round.activity[t].tasks << "}}";
+        }
+    }
+
+    out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"threads\": " << m_threads << "}}" << std::endl;
+}
+
+void boruvka_trace::write_summary(std::ostream &out) const {
+    auto flags = out.flags();
+    auto precision = out.precision();
+
+    out << std::fixed << std::setprecision(2)
+        << "round  components     scanned    filtered     added   search ms   commit ms  relabel ms"
+        << "   tasks  busy min/max ms" << std::endl;
+
+    double search = 0, commit = 0, relabel = 0;
+    std::size_t scanned = 0, filtered = 0, added = 0, tasks = 0;
+
+    for (std::size_t r = 0; r < m_rounds.size(); r++) {
+        auto const &round = m_rounds[r];
+
+        std::uint64_t round_tasks = 0, min_busy = UINT64_MAX, max_busy = 0;
+        for (std::size_t t = 0; t < round.activity.size(); t++) {
+            round_tasks += round.activity[t].tasks;
+
+            // the caller entry sums up all threads outside of the pool, only the workers show the balance
+            if (t + 1 == round.activity.size()) continue;
+            min_busy = std::min(min_busy, round.activity[t].busy_ns);
+            max_busy = std::max(max_busy, round.activity[t].busy_ns);
+        }
+
+        out << std::setw(5) << r + 1 << std::setw(12) << round.components << std::setw(12) << round.edges_scanned
+            << std::setw(12) << round.edges_filtered << std::setw(10) << round.edges_added
+            << std::setw(12) << round.search_us / 1000 << std::setw(12) << round.commit_us / 1000
+            << std::setw(12) << round.relabel_us / 1000 << std::setw(8) << round_tasks;
+
+        if (max_busy > 0)
+            out << std::setw(9) << min_busy / 1e6 << "/" << max_busy / 1e6;
+        else
+            out << std::setw(9) << "-";
+
+        out << std::endl;
+
+        search += round.search_us;
+        commit += round.commit_us;
+        relabel += round.relabel_us;
+        scanned += round.edges_scanned;
+        filtered += round.edges_filtered;
+        added += round.edges_added;
+        tasks += round_tasks;
+    }
+
+    out << "total" << std::setw(12) << "" << std::setw(12) << scanned << std::setw(12) << filtered
+        << std::setw(10) << added << std::setw(12) << search / 1000 << std::setw(12) << commit / 1000
+        << std::setw(12) << relabel / 1000 << std::setw(8) << tasks << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
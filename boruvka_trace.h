@@ -0,0 +1,70 @@
+#ifndef MINIMUM_SPANNING_TREE_BORUVKA_TRACE_H
+#define MINIMUM_SPANNING_TREE_BORUVKA_TRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "thread_pool.h"
+
+/**
+ * Measurements of one round of Borůvka's algorithm
+ */
+struct boruvka_round {
+    std::size_t components;         // before the round
+    std::size_t edges_scanned;
+    std::size_t edges_filtered;     // found inside a component and dropped for good
+    std::size_t edges_added;        // to the tree
+    double search_start_us;         // since the start of the trace
+    double search_us;
+    double commit_us;
+    double relabel_us;
+    std::vector<worker_activity> activity;     // of the pool during the round, empty for serial runs
+};
+
+/**
+ * Per-round instrumentation of boruvka_engine. The engine records every round when it is given a trace,
+ * see boruvka_engine::set_trace(), and the trace can be exported as a Chrome trace-event file
+ * (chrome://tracing or https://ui.perfetto.dev) or printed as a summary table.
+ */
+class boruvka_trace {
+public:
+    typedef std::chrono::steady_clock clock;
+
+private:
+    clock::time_point m_start{clock::now()};
+    std::vector<boruvka_round> m_rounds{};
+    std::size_t m_threads{0};
+
+public:
+    inline clock::time_point start() const { return m_start; }
+    inline std::vector<boruvka_round> const &rounds() const { return m_rounds; }
+
+    /**
+     * Records the number of threads of the pool, zero for serial runs
+     */
+    inline void set_threads(std::size_t threads) { m_threads = threads; }
+    inline void add_round(boruvka_round const &round) { m_rounds.push_back(round); }
+
+    /**
+     * Microseconds between the start of the trace and a time point
+     */
+    inline double since_start(clock::time_point t) const {
+        return std::chrono::duration<double, std::micro>(t - m_start).count();
+    }
+
+    /**
+     * Writes the rounds as a Chrome trace-event JSON: the phases of every round as complete events
+     * with the edge counts as arguments, and the busy time of every thread per round as counters
+     */
+    void write_chrome_trace(std::ostream &out) const;
+
+    /**
+     * Prints one line per round and the totals
+     */
+    void write_summary(std::ostream &out) const;
+};
+
+#endif //MINIMUM_SPANNING_TREE_BORUVKA_TRACE_H
@@ -0,0 +1,297 @@
+#include "cheapest_edge_kernel.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MST_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define MST_X86_KERNELS 0
+#endif
+
+namespace {
+    const std::uint64_t no_key = UINT64_MAX;
+
+    /**
+     * Scans the slots of one vertex
+     * @return Smallest live key
+     */
+    inline std::uint64_t scan_vertex(adjacency_slots const &slots, csr_graph::vertex_id const *labels, std::size_t v) {
+        auto targets = slots.targets + slots.offsets[v];
+        auto slot_keys = slots.keys + slots.offsets[v];
+        auto count = slots.counts[v];
+        auto label = labels[v];
+        auto best = no_key;
+        std::uint32_t live = 0;
+
+        for (std::uint32_t i = 0; i < count; i++) {
+            auto target = targets[i];
+            if (labels[target] == label) continue;
+
+            auto key = slot_keys[i];
+            if (key < best) best = key;
+
+            targets[live] = target;
+            slot_keys[live++] = key;
+        }
+
+        slots.counts[v] = live;
+        return best;
+    }
+
+    std::size_t scan_scalar(adjacency_slots const &slots, csr_graph::vertex_id const *labels,
+                            std::size_t begin, std::size_t end, std::uint64_t *keys) {
+        std::size_t total = 0;
+
+        for (auto v = begin; v < end; v++) {
+            keys[v] = scan_vertex(slots, labels, v);
+            total += slots.counts[v];
+        }
+
+        return total;
+    }
+
+#if MST_X86_KERNELS
+    /**
+     * Lane permutations moving the lanes selected by a mask to the front: for 8 x 32-bit lanes by an 8-bit mask
+     * and for 4 x 64-bit lanes (as pairs of 32-bit lanes) by a 4-bit mask
+     */
+    struct compress_tables {
+        alignas(32) std::uint32_t lanes32[256][8];
+        alignas(32) std::uint32_t lanes64[16][8];
+
+        compress_tables() : lanes32{}, lanes64{} {
+            for (unsigned mask = 0; mask < 256; mask++) {
+                unsigned next = 0;
+                for (unsigned lane = 0; lane < 8; lane++)
+                    if (mask & (1u << lane)) lanes32[mask][next++] = lane;
+            }
+
+            for (unsigned mask = 0; mask < 16; mask++) {
+                unsigned next = 0;
+                for (unsigned lane = 0; lane < 4; lane++) {
+                    if ((mask & (1u << lane)) == 0) continue;
+
+                    lanes64[mask][next++] = 2 * lane;
+                    lanes64[mask][next++] = 2 * lane + 1;
+                }
+            }
+        }
+    };
+
+    compress_tables const &tables() {
+        static const compress_tables instance;
+        return instance;
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i min_epu64(__m256i a, __m256i b) {
+        auto bias = _mm256_set1_epi64x(INT64_MIN);
+        auto a_greater = _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+        return _mm256_blendv_epi8(a, b, a_greater);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t scan_avx2(adjacency_slots const &slots, csr_graph::vertex_id const *labels,
+                          std::size_t begin, std::size_t end, std::uint64_t *keys) {
+        auto const &lut = tables();
+        auto const lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        auto const lanes64 = _mm256_setr_epi64x(0, 1, 2, 3);
+        auto const none = _mm256_set1_epi64x(-1);
+        auto const label_base = reinterpret_cast<int const *>(labels);
+        std::size_t total = 0;
+
+        for (auto v = begin; v < end; v++) {
+            auto count = slots.counts[v];
+
+            // a vector of mostly masked-out lanes costs more than the scalar loop
+            if (count < 8) {
+                keys[v] = scan_vertex(slots, labels, v);
+                total += slots.counts[v];
+                continue;
+            }
+
+            auto targets = slots.targets + slots.offsets[v];
+            auto slot_keys = slots.keys + slots.offsets[v];
+            auto label = _mm256_set1_epi32(static_cast<int>(labels[v]));
+            auto best = none;
+            std::uint32_t live = 0;
+
+            for (std::uint32_t i = 0; i < count; i += 8) {
+                auto rest = static_cast<int>(count - i < 8 ? count - i : 8);
+                auto in = _mm256_cmpgt_epi32(_mm256_set1_epi32(rest), lanes);
+
+                // lanes past the end gather nothing and keep the label of the vertex, so they count as inside
+                auto t = _mm256_maskload_epi32(reinterpret_cast<int const *>(targets + i), in);
+                auto target_labels = _mm256_mask_i32gather_epi32(label, label_base, t, in, 4);
+                auto out = _mm256_andnot_si256(_mm256_cmpeq_epi32(target_labels, label), in);
+
+                auto bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(out)));
+                if (bits == 0) continue;
+
+                auto in_low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(in));
+                auto in_high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(in, 1));
+                auto out_low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(out));
+                auto out_high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(out, 1));
+
+                auto k_low = _mm256_maskload_epi64(reinterpret_cast<long long const *>(slot_keys + i), in_low);
+                auto k_high = _mm256_maskload_epi64(reinterpret_cast<long long const *>(slot_keys + i + 4), in_high);
+
+                best = min_epu64(best, _mm256_blendv_epi8(none, k_low, out_low));
+                best = min_epu64(best, _mm256_blendv_epi8(none, k_high, out_high));
+
+                // the live slots are compressed to the front; the stores never pass the slots already loaded
+                auto kept = static_cast<int>(__builtin_popcount(bits));
+                auto kept_low = static_cast<int>(__builtin_popcount(bits & 0xF));
+
+                auto perm = _mm256_load_si256(reinterpret_cast<__m256i const *>(lut.lanes32[bits]));
+                _mm256_maskstore_epi32(reinterpret_cast<int *>(targets + live),
+                                       _mm256_cmpgt_epi32(_mm256_set1_epi32(kept), lanes),
+                                       _mm256_permutevar8x32_epi32(t, perm));
+
+                auto perm_low = _mm256_load_si256(reinterpret_cast<__m256i const *>(lut.lanes64[bits & 0xF]));
+                auto perm_high = _mm256_load_si256(reinterpret_cast<__m256i const *>(lut.lanes64[bits >> 4]));
+                _mm256_maskstore_epi64(reinterpret_cast<long long *>(slot_keys + live),
+                                       _mm256_cmpgt_epi64(_mm256_set1_epi64x(kept_low), lanes64),
+                                       _mm256_permutevar8x32_epi32(k_low, perm_low));
+                _mm256_maskstore_epi64(reinterpret_cast<long long *>(slot_keys + live + kept_low),
+                                       _mm256_cmpgt_epi64(_mm256_set1_epi64x(kept - kept_low), lanes64),
+                                       _mm256_permutevar8x32_epi32(k_high, perm_high));
+
+                live += static_cast<std::uint32_t>(kept);
+            }
+
+            alignas(32) std::uint64_t lane_best[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lane_best), best);
+
+            auto key = lane_best[0];
+            for (unsigned lane = 1; lane < 4; lane++) if (lane_best[lane] < key) key = lane_best[lane];
+
+            slots.counts[v] = live;
+            keys[v] = key;
+            total += live;
+        }
+
+        return total;
+    }
+
+    __attribute__((target("avx512f")))
+    std::size_t scan_avx512(adjacency_slots const &slots, csr_graph::vertex_id const *labels,
+                            std::size_t begin, std::size_t end, std::uint64_t *keys) {
+        std::size_t total = 0;
+
+        for (auto v = begin; v < end; v++) {
+            auto count = slots.counts[v];
+
+            if (count < 16) {
+                keys[v] = scan_vertex(slots, labels, v);
+                total += slots.counts[v];
+                continue;
+            }
+
+            auto targets = slots.targets + slots.offsets[v];
+            auto slot_keys = slots.keys + slots.offsets[v];
+            auto label = _mm512_set1_epi32(static_cast<int>(labels[v]));
+            auto best = _mm512_set1_epi64(-1);
+            std::uint32_t live = 0;
+
+            for (std::uint32_t i = 0; i < count; i += 16) {
+                auto rest = count - i;
+                auto in = static_cast<__mmask16>(rest >= 16 ? 0xFFFF : (1u << rest) - 1);
+
+                auto t = _mm512_maskz_loadu_epi32(in, targets + i);
+                auto target_labels = _mm512_mask_i32gather_epi32(label, in, t, labels, 4);
+                auto out = _mm512_mask_cmpneq_epi32_mask(in, target_labels, label);
+                if (out == 0) continue;
+
+                auto out_low = static_cast<__mmask8>(out & 0xFF), out_high = static_cast<__mmask8>(out >> 8);
+                auto k_low = _mm512_maskz_loadu_epi64(static_cast<__mmask8>(in & 0xFF), slot_keys + i);
+                auto k_high = _mm512_maskz_loadu_epi64(static_cast<__mmask8>(in >> 8), slot_keys + i + 8);
+
+                best = _mm512_mask_min_epu64(best, out_low, best, k_low);
+                best = _mm512_mask_min_epu64(best, out_high, best, k_high);
+
+                // the live slots are compressed to the front; the stores never pass the slots already loaded
+                auto kept_low = static_cast<std::uint32_t>(__builtin_popcount(out_low));
+
+                _mm512_mask_compressstoreu_epi32(targets + live, out, t);
+                _mm512_mask_compressstoreu_epi64(slot_keys + live, out_low, k_low);
+                _mm512_mask_compressstoreu_epi64(slot_keys + live + kept_low, out_high, k_high);
+
+                live += static_cast<std::uint32_t>(__builtin_popcount(out));
+            }
+
+            alignas(64) std::uint64_t lane_best[8];
+            _mm512_store_si512(lane_best, best);
+
+            auto key = lane_best[0];
+            for (unsigned lane = 1; lane < 8; lane++) if (lane_best[lane] < key) key = lane_best[lane];
+
+            slots.counts[v] = live;
+            keys[v] = key;
+            total += live;
+        }
+
+        return total;
+    }
+#endif
+
+    typedef std::size_t (*kernel_t)(adjacency_slots const &, csr_graph::vertex_id const *,
+                                    std::size_t, std::size_t, std::uint64_t *);
+
+    kernel_t kernel_for(simd_level level) {
+#if MST_X86_KERNELS
+        if (level == simd_level::avx512) return scan_avx512;
+        if (level == simd_level::avx2) return scan_avx2;
+#endif
+        return scan_scalar;
+    }
+
+    simd_level active_level = detect_simd_level();
+    kernel_t active_kernel = kernel_for(active_level);
+}
+
+simd_level detect_simd_level() {
+#if MST_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+#endif
+    return simd_level::scalar;
+}
+
+simd_level active_simd_level() {
+    return active_level;
+}
+
+bool set_simd_level(simd_level level) {
+    if (static_cast<int>(level) > static_cast<int>(detect_simd_level())) return false;
+
+    active_level = level;
+    active_kernel = kernel_for(level);
+
+    return true;
+}
+
+bool parse_simd_level(std::string const &name, simd_level &level) {
+    if (name == "scalar") level = simd_level::scalar;
+    else if (name == "avx2") level = simd_level::avx2;
+    else if (name == "avx512") level = simd_level::avx512;
+    else return false;
+
+    return true;
+}
+
+std::string to_string(simd_level level) {
+    switch (level) {
+        case simd_level::avx2:
+            return "avx2";
+        case simd_level::avx512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+std::size_t cheapest_leaving_edges(adjacency_slots const &slots, csr_graph::vertex_id const *labels,
+                                   std::size_t begin, std::size_t end, std::uint64_t *keys) {
+    return active_kernel(slots, labels, begin, end, keys);
+}
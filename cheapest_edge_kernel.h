@@ -0,0 +1,70 @@
+#ifndef MINIMUM_SPANNING_TREE_CHEAPEST_EDGE_KERNEL_H
+#define MINIMUM_SPANNING_TREE_CHEAPEST_EDGE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "csr_graph.h"
+
+/**
+ * Instruction sets the cheapest-edge kernel is compiled for
+ */
+enum class simd_level {
+    scalar, avx2, avx512
+};
+
+/**
+ * @return The best level supported by the processor (and the compiler)
+ */
+simd_level detect_simd_level();
+
+/**
+ * @return The level used by cheapest_leaving_edges(), detect_simd_level() unless changed
+ */
+simd_level active_simd_level();
+
+/**
+ * Selects the kernel used by cheapest_leaving_edges(), e.g. to compare the implementations.
+ * Not thread-safe: call it before any kernel runs.
+ * @param level Requested level
+ * @return False if the processor does not support the level, the kernel is unchanged then
+ */
+bool set_simd_level(simd_level level);
+
+/**
+ * Parses "scalar", "avx2" or "avx512"
+ * @return False if the name is unknown
+ */
+bool parse_simd_level(std::string const &name, simd_level &level);
+
+std::string to_string(simd_level level);
+
+/**
+ * Adjacency of the vertices in structure-of-arrays form. Every vertex owns the slots
+ * [offsets[v], offsets[v] + counts[v]); slots which turn out to be inside a component are dropped
+ * by compacting the slots of the vertex in place, so counts only shrink.
+ */
+struct adjacency_slots {
+    std::size_t const *offsets;
+    std::uint32_t *counts;
+    csr_graph::vertex_id *targets;
+    std::uint64_t *keys;        // weight << 32 | edge id, so the smallest key is the csr_graph::lighter() minimum
+};
+
+/**
+ * Finds the lightest edge of every vertex in [begin, end) which leaves the component of the vertex,
+ * and drops the slots of all other edges of these vertices for good.
+ *
+ * The AVX2 and AVX-512 kernels process 8 and 16 slots at once: the labels of the targets are gathered,
+ * compared with the label of the vertex, the live keys are folded into a vector minimum and the live slots
+ * are compressed to the front of the segment. Tails are handled with masked loads.
+ * @param slots Adjacency of the graph
+ * @param labels Component label of every vertex; the SIMD kernels index it with signed 32-bit integers,
+ *               so the graph must have less than 2^31 vertices
+ * @param keys Receives the smallest live key of every vertex in the range, UINT64_MAX if there is none
+ * @return Number of live slots of the range afterwards
+ */
+std::size_t cheapest_leaving_edges(adjacency_slots const &slots, csr_graph::vertex_id const *labels,
+                                   std::size_t begin, std::size_t end, std::uint64_t *keys);
+
+#endif //MINIMUM_SPANNING_TREE_CHEAPEST_EDGE_KERNEL_H
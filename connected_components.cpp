@@ -0,0 +1,137 @@
+#include "connected_components.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include "thread_pool.h"
+
+namespace {
+    typedef csr_graph::vertex_id vertex_id;
+    typedef std::atomic<vertex_id> parent_t;
+
+    /**
+     * Neighbors of every vertex linked before the giant component is estimated
+     */
+    const std::size_t neighbor_rounds = 2;
+
+    /**
+     * Vertices sampled to find the giant component
+     */
+    const std::size_t sample_size = 1024;
+
+    /**
+     * Joins the trees of u and v: the root with the larger id is hooked under the other tree. A failed
+     * compare-and-swap means another thread hooked the root meanwhile, so the roots are looked up again.
+     */
+    inline void link(parent_t *parents, vertex_id u, vertex_id v) {
+        auto p1 = parents[u].load(std::memory_order_relaxed);
+        auto p2 = parents[v].load(std::memory_order_relaxed);
+
+        while (p1 != p2) {
+            auto high = std::max(p1, p2), low = std::min(p1, p2);
+            auto high_parent = parents[high].load(std::memory_order_relaxed);
+
+            if (high_parent == low) break;
+            if (high_parent == high &&
+                parents[high].compare_exchange_strong(high_parent, low, std::memory_order_relaxed))
+                break;
+
+            p1 = parents[parents[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+            p2 = parents[low].load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Points every vertex of the range directly to the root of its tree
+     */
+    void compress(parent_t *parents, std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++) {
+            auto parent = parents[v].load(std::memory_order_relaxed);
+
+            while (parent != parents[parent].load(std::memory_order_relaxed)) {
+                parent = parents[parent].load(std::memory_order_relaxed);
+                parents[v].store(parent, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Runs the body over [0, n) with the pool or in the calling thread
+     */
+    template<typename Body>
+    void for_range(thread_pool *pool, std::size_t n, Body const &body) {
+        if (pool != nullptr) {
+            pool->parallel_for(0, n, 0, body);
+        } else {
+            body(0, n);
+        }
+    }
+
+    /**
+     * Estimates the largest component from the roots of a fixed random sample of vertices
+     */
+    vertex_id most_frequent_root(parent_t const *parents, std::size_t vertex_count) {
+        std::mt19937 random{42};
+        std::uniform_int_distribution<std::size_t> pick{0, vertex_count - 1};
+        std::unordered_map<vertex_id, std::size_t> counts;
+
+        for (std::size_t i = 0; i < sample_size; i++) ++counts[parents[pick(random)].load(std::memory_order_relaxed)];
+
+        return std::max_element(counts.begin(), counts.end(), [](std::pair<const vertex_id, std::size_t> const &a,
+                                                                 std::pair<const vertex_id, std::size_t> const &b) {
+            return a.second < b.second;
+        })->first;
+    }
+}
+
+graph_components connected_components(csr_graph const &g, thread_pool *pool) {
+    auto vertex_count = g.vertex_count();
+    auto offsets = g.offsets();
+    auto neighbors = g.neighbors();
+
+    graph_components components{std::vector<vertex_id>(vertex_count), 0};
+    if (vertex_count == 0) return components;
+
+    std::unique_ptr<parent_t[]> parents{new parent_t[vertex_count]};
+    auto data = parents.get();
+
+    for_range(pool, vertex_count, [data](std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++) data[v].store(static_cast<vertex_id>(v), std::memory_order_relaxed);
+    });
+
+    auto compress_all = [data](std::size_t begin, std::size_t end) { compress(data, begin, end); };
+
+    for (std::size_t round = 0; round < neighbor_rounds; round++) {
+        for_range(pool, vertex_count, [&](std::size_t begin, std::size_t end) {
+            for (auto v = begin; v < end; v++)
+                if (offsets[v] + round < offsets[v + 1])
+                    link(data, static_cast<vertex_id>(v), neighbors[offsets[v] + round]);
+        });
+
+        for_range(pool, vertex_count, compress_all);
+    }
+
+    auto giant = most_frequent_root(data, vertex_count);
+
+    // every edge is listed at both endpoints, so an edge leaving the giant component is linked from its other end
+    for_range(pool, vertex_count, [&](std::size_t begin, std::size_t end) {
+        for (auto v = begin; v < end; v++) {
+            if (data[v].load(std::memory_order_relaxed) == giant) continue;
+
+            for (auto slot = offsets[v] + neighbor_rounds; slot < offsets[v + 1]; slot++)
+                link(data, static_cast<vertex_id>(v), neighbors[slot]);
+        }
+    });
+
+    for_range(pool, vertex_count, compress_all);
+
+    // a root has the smallest id of its tree, so the ids are dense and ordered in one ascending pass
+    for (std::size_t v = 0; v < vertex_count; v++) {
+        auto root = data[v].load(std::memory_order_relaxed);
+
+        components.labels[v] = root == v ? static_cast<vertex_id>(components.count++) : components.labels[root];
+    }
+
+    return components;
+}
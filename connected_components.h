@@ -0,0 +1,31 @@
+#ifndef MINIMUM_SPANNING_TREE_CONNECTED_COMPONENTS_H
+#define MINIMUM_SPANNING_TREE_CONNECTED_COMPONENTS_H
+
+#include <cstddef>
+#include <vector>
+#include "csr_graph.h"
+
+class thread_pool;
+
+/**
+ * Connected components of a graph
+ */
+struct graph_components {
+    std::vector<csr_graph::vertex_id> labels;   // component of every vertex, numbered 0..count-1
+    std::size_t count;                          // in the order of the smallest vertex of each component
+};
+
+/**
+ * Finds the connected components with the Afforest algorithm (Sutton, Ben-Nun and Barak), a variant of
+ * Shiloach-Vishkin. Every vertex starts as a tree of its own; an edge hooks the root of the larger id under
+ * the smaller one with a compare-and-swap, and pointer jumping flattens the trees. The first two neighbors
+ * of every vertex are linked first, which usually forms one giant component; its id is then estimated from
+ * a sample of vertices and the remaining edges are linked only for vertices outside of it, so most edges of
+ * the giant component are never touched. No recursion is involved, so long paths need no extra stack.
+ * @param g CSR graph
+ * @param pool Pool linking the vertices, nullptr runs everything in the calling thread
+ * @return The components
+ */
+graph_components connected_components(csr_graph const &g, thread_pool *pool);
+
+#endif //MINIMUM_SPANNING_TREE_CONNECTED_COMPONENTS_H
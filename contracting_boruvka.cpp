@@ -0,0 +1,268 @@
+#include "mst_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include "arena.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+namespace {
+    const std::uint64_t no_key = UINT64_MAX;
+    const std::uint32_t no_vertex = UINT32_MAX;
+
+    /**
+     * Blocks shorter than this are not worth a separate task
+     */
+    const std::size_t min_contract_block_size = 4096;
+
+    /**
+     * Edge of the contracted multigraph between two super-vertices, standing for an original edge
+     * whose weight and id decide the order like csr_graph::lighter() does
+     */
+    struct contracted_edge {
+        csr_graph::vertex_id source;
+        csr_graph::vertex_id target;
+        csr_graph::edge_id id;
+        weight_t weight;
+    };
+
+    /**
+     * The edges of the first round are read from the graph itself, so they are not copied
+     */
+    struct graph_edges {
+        csr_graph const &g;
+
+        inline std::size_t size() const { return g.edge_count(); }
+        inline contracted_edge operator[](std::size_t e) const {
+            return contracted_edge{g.sources()[e], g.targets()[e], static_cast<csr_graph::edge_id>(e), g.weights()[e]};
+        }
+    };
+
+    struct array_edges {
+        contracted_edge const *data;
+        std::size_t count;
+
+        inline std::size_t size() const { return count; }
+        inline contracted_edge const &operator[](std::size_t e) const { return data[e]; }
+    };
+
+    /**
+     * Per-vertex buffers sized for the original graph, allocated once and reused by every round
+     */
+    struct round_buffers {
+        std::atomic<std::uint64_t> *best;
+        csr_graph::edge_id *cheapest;
+        csr_graph::vertex_id *mapping;
+        csr_graph::vertex_id *roots;
+        std::size_t *offsets;
+        std::size_t *next;
+        std::size_t *slot;
+        csr_graph::vertex_id *owner;
+
+        round_buffers(std::size_t vertex_count, arena &scratch)
+                : best{scratch.allocate_array<std::atomic<std::uint64_t>>(vertex_count)},
+                  cheapest{scratch.allocate_array<csr_graph::edge_id>(vertex_count)},
+                  mapping{scratch.allocate_array<csr_graph::vertex_id>(vertex_count)},
+                  roots{scratch.allocate_array<csr_graph::vertex_id>(vertex_count)},
+                  offsets{scratch.allocate_array<std::size_t>(vertex_count + 1)},
+                  next{scratch.allocate_array<std::size_t>(vertex_count)},
+                  slot{scratch.allocate_array<std::size_t>(vertex_count)},
+                  owner{scratch.allocate_array<csr_graph::vertex_id>(vertex_count)} {}
+    };
+
+    /**
+     * Lowers the target to value if value is less, retrying the compare-and-swap while other threads race it
+     */
+    template<typename Less>
+    inline void atomic_min(std::atomic<std::uint64_t> &target, std::uint64_t value, Less const &less) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (less(value, current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * Finds the id of the cheapest original edge of every super-vertex and stores it in buffers.cheapest,
+     * csr_graph::no_edge for super-vertices without edges
+     * @param packed True if all weights fit into 32 bits, then the key is (weight << 32 | id),
+     *               otherwise the key is the id and the keys are compared through the graph
+     */
+    template<typename Edges>
+    void find_cheapest(csr_graph const &g, Edges const &edges, std::size_t vertex_count, bool packed,
+                       round_buffers &buffers, thread_pool *pool) {
+        auto best = buffers.best;
+        for (std::size_t v = 0; v < vertex_count; v++) best[v].store(no_key, std::memory_order_relaxed);
+
+        auto threads = pool != nullptr ? pool->size() : 1;
+        auto block_count = std::max<std::size_t>(1, std::min(edges.size() / min_contract_block_size, 8 * threads));
+        auto block_length = (edges.size() + block_count - 1) / block_count;
+
+        for_each_task(pool, block_count, [&](std::size_t block) {
+            auto end = std::min(edges.size(), (block + 1) * block_length);
+
+            for (auto i = block * block_length; i < end; i++) {
+                auto e = edges[i];
+
+                if (packed) {
+                    auto key = (static_cast<std::uint64_t>(e.weight) << 32) | e.id;
+                    atomic_min(best[e.source], key, std::less<std::uint64_t>());
+                    atomic_min(best[e.target], key, std::less<std::uint64_t>());
+                } else {
+                    auto lighter = [&g](std::uint64_t x, std::uint64_t y) {
+                        return y == no_key || g.lighter(static_cast<csr_graph::edge_id>(x),
+                                                        static_cast<csr_graph::edge_id>(y));
+                    };
+                    atomic_min(best[e.source], e.id, lighter);
+                    atomic_min(best[e.target], e.id, lighter);
+                }
+            }
+        });
+
+        for (std::size_t v = 0; v < vertex_count; v++) {
+            auto key = best[v].load(std::memory_order_relaxed);
+            buffers.cheapest[v] = key == no_key ? csr_graph::no_edge : static_cast<csr_graph::edge_id>(key & UINT32_MAX);
+        }
+    }
+
+    /**
+     * Contracts the edges onto the new super-vertices: self-loops are dropped and of all parallel edges only
+     * the lightest one is kept. A stable counting sort buckets the edges by their smaller endpoint, then every
+     * bucket is deduplicated with a slot array indexed by the larger endpoint, so a round takes linear time.
+     * @param edges Edges over the old super-vertices
+     * @param vertex_count Number of new super-vertices, buffers.mapping holds the new one of every old one
+     * @param output Receives the edges over the new super-vertices, ordered by their smaller endpoint;
+     *               has room for all edges which are not self-loops
+     * @return Number of edges written to the output
+     */
+    template<typename Edges>
+    std::size_t contract(csr_graph const &g, Edges const &edges, std::size_t vertex_count, round_buffers &buffers,
+                         contracted_edge *output) {
+        auto mapping = buffers.mapping;
+        auto offsets = buffers.offsets;
+        std::fill(offsets, offsets + vertex_count + 1, 0);
+
+        for (std::size_t i = 0; i < edges.size(); i++) {
+            auto e = edges[i];
+            auto a = mapping[e.source], b = mapping[e.target];
+            if (a != b) ++offsets[std::min(a, b) + 1];
+        }
+
+        for (std::size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+        auto next = buffers.next;
+        std::copy(offsets, offsets + vertex_count, next);
+
+        for (std::size_t i = 0; i < edges.size(); i++) {
+            auto e = edges[i];
+            auto a = mapping[e.source], b = mapping[e.target];
+            if (a == b) continue;
+
+            output[next[std::min(a, b)]++] = contracted_edge{std::min(a, b), std::max(a, b), e.id, e.weight};
+        }
+
+        // slot[b] is the kept edge between the current smaller endpoint and b, owner[b] tells whether it belongs
+        // to the current one, so the arrays never have to be cleared
+        auto slot = buffers.slot;
+        auto owner = buffers.owner;
+        std::fill(owner, owner + vertex_count, no_vertex);
+        std::size_t kept = 0;
+
+        for (std::size_t i = 0; i < offsets[vertex_count]; i++) {
+            auto const e = output[i];
+
+            if (owner[e.target] != e.source) {
+                owner[e.target] = e.source;
+                slot[e.target] = kept;
+                output[kept++] = e;
+            } else if (g.lighter(e.id, output[slot[e.target]].id)) {
+                output[slot[e.target]] = e;
+            }
+        }
+
+        return kept;
+    }
+}
+
+edge_ids_t contracting_boruvka_mst::run(csr_graph const &g, thread_pool *pool, arena &scratch) const {
+    auto vertex_count = g.vertex_count();
+    auto edge_count = g.edge_count();
+    auto sources = g.sources();
+    auto targets = g.targets();
+    auto weights = g.weights();
+
+    auto max_weight = edge_count > 0 ? *std::max_element(weights, weights + edge_count) : 0;
+    auto packed = max_weight <= UINT32_MAX;
+
+    edge_ids_t tree;
+    tree.reserve(vertex_count);
+
+    round_buffers buffers{vertex_count, scratch};
+    arena_union_find sets{vertex_count, arena_allocator<union_find::id_t>(scratch)};
+
+    // super-vertex of every original vertex, used to find the endpoints of the cheapest edges
+    auto super = scratch.allocate_array<csr_graph::vertex_id>(vertex_count);
+    for (std::size_t v = 0; v < vertex_count; v++) super[v] = static_cast<csr_graph::vertex_id>(v);
+
+    // the rounds alternate between two edge buffers: the first one fits the edges of the graph,
+    // the second one the (never more) edges left after the first contraction
+    contracted_edge *buffer[2] = {edge_count > 0 ? scratch.allocate_array<contracted_edge>(edge_count) : nullptr,
+                                  nullptr};
+    array_edges edges{nullptr, 0};
+    auto count = vertex_count;
+    auto first = true;
+
+    // super-vertices are renumbered densely after every round, so the used part of every buffer shrinks
+    while (count > 1 && (first ? edge_count : edges.size()) > 0) {
+        if (first) {
+            find_cheapest(g, graph_edges{g}, count, packed, buffers, pool);
+        } else {
+            find_cheapest(g, edges, count, packed, buffers, pool);
+        }
+
+        sets.reset(count);
+        auto committed = tree.size();
+
+        for (std::size_t v = 0; v < count; v++) {
+            auto e = buffers.cheapest[v];
+
+            // both super-vertices may have picked the same edge, the union-find filters the duplicate out
+            if (e != csr_graph::no_edge && sets.unite(super[sources[e]], super[targets[e]])) tree.push_back(e);
+        }
+
+        auto sink = tree_sink();
+        if (sink != nullptr && tree.size() > committed) (*sink)(tree.data() + committed, tree.size() - committed);
+
+        // every super-vertex with an edge left is merged with another one, so their number at least halves
+        std::size_t next_count = 0;
+        std::fill(buffers.roots, buffers.roots + count, no_vertex);
+
+        for (std::size_t v = 0; v < count; v++) {
+            auto root = sets.find(static_cast<union_find::id_t>(v));
+            if (buffers.roots[root] == no_vertex) buffers.roots[root] = static_cast<csr_graph::vertex_id>(next_count++);
+            buffers.mapping[v] = buffers.roots[root];
+        }
+
+        if (first) {
+            auto kept = contract(g, graph_edges{g}, next_count, buffers, buffer[0]);
+            edges = array_edges{buffer[0], kept};
+        } else {
+            if (buffer[1] == nullptr) buffer[1] = scratch.allocate_array<contracted_edge>(edges.size());
+
+            auto output = edges.data == buffer[0] ? buffer[1] : buffer[0];
+            edges = array_edges{output, contract(g, edges, next_count, buffers, output)};
+        }
+
+        auto mapping = buffers.mapping;
+
+        if (pool != nullptr) {
+            pool->parallel_for(0, vertex_count, 0, [&](std::size_t begin, std::size_t end) {
+                for (auto v = begin; v < end; v++) super[v] = mapping[super[v]];
+            });
+        } else {
+            for (std::size_t v = 0; v < vertex_count; v++) super[v] = mapping[super[v]];
+        }
+
+        count = next_count;
+        first = false;
+    }
+
+    return tree;
+}
@@ -0,0 +1,139 @@
+#include "csr_graph.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "graph.h"
+
+constexpr csr_graph::edge_id csr_graph::no_edge;
+
+/**
+ * Owned arrays of a graph built in memory
+ */
+struct csr_graph::buffers {
+    std::vector<vertex> labels;
+    std::vector<std::size_t> offsets;
+    std::vector<vertex_id> neighbors;
+    std::vector<weight_t> neighbor_weights;
+    std::vector<edge_id> neighbor_edges;
+    std::vector<vertex_id> sources;
+    std::vector<vertex_id> targets;
+    std::vector<weight_t> weights;
+};
+
+csr_graph::csr_graph(graph const &g) {
+    if (g.vertices().size() > std::numeric_limits<vertex_id>::max() || g.edges().size() >= no_edge)
+        throw std::length_error("Graph is too large for the CSR representation!");
+
+    // vertices are stored in a sorted set, so the dense ids preserve the order of the labels
+    std::vector<vertex> labels(g.vertices().begin(), g.vertices().end());
+
+    auto dense_id = [&labels](vertex v) {
+        return static_cast<vertex_id>(std::lower_bound(labels.begin(), labels.end(), v) - labels.begin());
+    };
+
+    std::vector<vertex_id> sources, targets;
+    std::vector<weight_t> weights;
+
+    sources.reserve(g.edges().size());
+    targets.reserve(g.edges().size());
+    weights.reserve(g.edges().size());
+
+    for (auto const &e : g.edges()) {
+        sources.push_back(dense_id(e.start));
+        targets.push_back(dense_id(e.end));
+        weights.push_back(e.weight);
+    }
+
+    *this = csr_graph(std::move(labels), std::move(sources), std::move(targets), std::move(weights));
+}
+
+csr_graph::csr_graph(std::vector<vertex> labels, std::vector<vertex_id> sources, std::vector<vertex_id> targets,
+                     std::vector<weight_t> weights) {
+    if (labels.size() > std::numeric_limits<vertex_id>::max() || weights.size() >= no_edge)
+        throw std::length_error("Graph is too large for the CSR representation!");
+
+    auto data = std::make_shared<buffers>();
+    auto vertex_count = labels.size();
+    auto edge_count = weights.size();
+
+    data->labels = std::move(labels);
+    data->sources = std::move(sources);
+    data->targets = std::move(targets);
+    data->weights = std::move(weights);
+
+    // count the degrees and turn them into offsets by an exclusive prefix sum
+    auto &offsets = data->offsets;
+    offsets.assign(vertex_count + 1, 0);
+
+    for (std::size_t e = 0; e < edge_count; e++) {
+        ++offsets[data->sources[e] + 1];
+        ++offsets[data->targets[e] + 1];
+    }
+
+    for (std::size_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] += offsets[v];
+
+    data->neighbors.resize(2 * edge_count);
+    data->neighbor_weights.resize(2 * edge_count);
+    data->neighbor_edges.resize(2 * edge_count);
+
+    // scatter each edge to the adjacency of both of its endpoints
+    std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+
+    for (std::size_t e = 0; e < edge_count; e++) {
+        auto s = data->sources[e], t = data->targets[e];
+
+        auto slot = next[s]++;
+        data->neighbors[slot] = t;
+        data->neighbor_weights[slot] = data->weights[e];
+        data->neighbor_edges[slot] = static_cast<edge_id>(e);
+
+        slot = next[t]++;
+        data->neighbors[slot] = s;
+        data->neighbor_weights[slot] = data->weights[e];
+        data->neighbor_edges[slot] = static_cast<edge_id>(e);
+    }
+
+    m_arrays = arrays{vertex_count, edge_count,
+                      data->labels.data(), data->offsets.data(),
+                      data->neighbors.data(), data->neighbor_weights.data(), data->neighbor_edges.data(),
+                      data->sources.data(), data->targets.data(), data->weights.data()};
+    m_storage = std::move(data);
+}
+
+csr_graph::csr_graph(arrays const &a, std::shared_ptr<void const> storage)
+        : m_storage{std::move(storage)}, m_arrays(a) {}
+
+csr_graph::vertex_id csr_graph::find_vertex(vertex v) const {
+    auto begin = m_arrays.labels, end = m_arrays.labels + m_arrays.vertex_count;
+
+    // sorted distinct labels ending with n - 1 are exactly 0..n-1, as in generated graphs
+    if (begin != end && *(end - 1) == m_arrays.vertex_count - 1)
+        return v < m_arrays.vertex_count ? static_cast<vertex_id>(v) : static_cast<vertex_id>(m_arrays.vertex_count);
+
+    auto it = std::lower_bound(begin, end, v);
+
+    if (it == end || *it != v)
+        return static_cast<vertex_id>(m_arrays.vertex_count);
+
+    return static_cast<vertex_id>(it - begin);
+}
+
+csr_graph::edge_id csr_graph::find_edge(vertex_id a, vertex_id b) const {
+    if (degree(b) < degree(a)) std::swap(a, b);
+
+    for (auto slot = m_arrays.offsets[a]; slot < m_arrays.offsets[a + 1]; slot++)
+        if (m_arrays.neighbors[slot] == b) return m_arrays.neighbor_edges[slot];
+
+    return no_edge;
+}
+
+graph csr_graph::to_graph(std::vector<edge_id> const &edges) const {
+    graph g{};
+
+    for (std::size_t v = 0; v < vertex_count(); v++) g.add_vertex(label(static_cast<vertex_id>(v)));
+    for (auto e : edges) g.add_edge(to_edge(e));
+
+    return g;
+}
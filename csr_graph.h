@@ -0,0 +1,140 @@
+#ifndef MINIMUM_SPANNING_TREE_CSR_GRAPH_H
+#define MINIMUM_SPANNING_TREE_CSR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "edge.h"
+
+class graph;
+
+/**
+ * Immutable compressed sparse row (CSR) representation of an undirected graph.
+ *
+ * Vertices are renumbered to dense ids 0..n-1 in the order of their original labels.
+ * Every undirected edge is stored once in the packed edge arrays (source, target, weight) and
+ * twice in the adjacency arrays, once for each of its endpoints. The adjacency of vertex v is
+ * the slot range [offsets()[v], offsets()[v + 1]).
+ *
+ * The graph only holds pointers to its arrays and shares ownership of the memory behind them,
+ * so the arrays may live in owned buffers as well as in a memory-mapped file, and copies are cheap.
+ */
+class csr_graph {
+public:
+    typedef std::uint32_t vertex_id;
+    typedef std::uint32_t edge_id;
+
+    /**
+     * Sentinel used in place of an edge id when there is no edge
+     */
+    static constexpr edge_id no_edge = UINT32_MAX;
+
+    /**
+     * Pointers to the arrays of a graph stored elsewhere, see csr_graph(arrays const &, std::shared_ptr<void const>)
+     */
+    struct arrays {
+        std::size_t vertex_count;
+        std::size_t edge_count;
+        vertex const *labels;               // vertex_count
+        std::size_t const *offsets;         // vertex_count + 1
+        vertex_id const *neighbors;         // 2 * edge_count
+        weight_t const *neighbor_weights;   // 2 * edge_count
+        edge_id const *neighbor_edges;      // 2 * edge_count
+        vertex_id const *sources;           // edge_count
+        vertex_id const *targets;           // edge_count
+        weight_t const *weights;            // edge_count
+    };
+
+private:
+    struct buffers;
+
+    std::shared_ptr<void const> m_storage{};
+    arrays m_arrays{};
+
+public:
+    /**
+     * Builds the CSR representation of a graph. Edge ids follow the iteration order of graph::edges(),
+     * so they are ordered by (weight, start, end).
+     * @param g Graph to convert
+     */
+    explicit csr_graph(graph const &g);
+
+    /**
+     * Builds the CSR representation from an edge list over dense vertex ids
+     * @param labels Original labels of the vertices, sorted ascending
+     * @param sources Source of every edge
+     * @param targets Target of every edge
+     * @param weights Weight of every edge
+     */
+    csr_graph(std::vector<vertex> labels, std::vector<vertex_id> sources, std::vector<vertex_id> targets,
+              std::vector<weight_t> weights);
+
+    /**
+     * Wraps arrays which already are in the CSR layout without copying them
+     * @param a Pointers to the arrays
+     * @param storage Owner of the memory the arrays point to
+     */
+    csr_graph(arrays const &a, std::shared_ptr<void const> storage);
+
+    inline std::size_t vertex_count() const { return m_arrays.vertex_count; }
+    inline std::size_t edge_count() const { return m_arrays.edge_count; }
+
+    inline vertex label(vertex_id v) const { return m_arrays.labels[v]; }
+
+    /**
+     * Finds the dense id of a vertex by its original label (binary search over the sorted labels, none if they
+     * are 0..n-1).
+     * If the vertex is not a part of the graph, vertex_count() is returned.
+     * @param v Original vertex label
+     * @return Dense vertex id
+     */
+    vertex_id find_vertex(vertex v) const;
+
+    /**
+     * Finds the edge between two vertices by scanning the adjacency of the one with the smaller degree
+     * @param a Dense id of one endpoint
+     * @param b Dense id of the other endpoint
+     * @return Edge id or no_edge if the vertices are not adjacent
+     */
+    edge_id find_edge(vertex_id a, vertex_id b) const;
+
+    inline std::size_t degree(vertex_id v) const { return m_arrays.offsets[v + 1] - m_arrays.offsets[v]; }
+
+    inline vertex const *labels() const { return m_arrays.labels; }
+    inline std::size_t const *offsets() const { return m_arrays.offsets; }
+    inline vertex_id const *neighbors() const { return m_arrays.neighbors; }
+    inline weight_t const *neighbor_weights() const { return m_arrays.neighbor_weights; }
+    inline edge_id const *neighbor_edges() const { return m_arrays.neighbor_edges; }
+
+    inline vertex_id const *sources() const { return m_arrays.sources; }
+    inline vertex_id const *targets() const { return m_arrays.targets; }
+    inline weight_t const *weights() const { return m_arrays.weights; }
+
+    /**
+     * Compares two edges by (weight, id). Edge ids are unique, so this is a strict total order
+     * which every MST engine uses to break ties between equally heavy edges.
+     */
+    inline bool lighter(edge_id a, edge_id b) const {
+        auto weights = m_arrays.weights;
+        return weights[a] < weights[b] || (weights[a] == weights[b] && a < b);
+    }
+
+    /**
+     * Converts an edge back to the original labels.
+     * @param e Edge id
+     * @return Edge between the original vertices
+     */
+    inline edge to_edge(edge_id e) const {
+        return edge(label(m_arrays.sources[e]), label(m_arrays.targets[e]), m_arrays.weights[e]);
+    }
+
+    /**
+     * Builds a graph containing all vertices of this graph and the given subset of its edges.
+     * @param edges Ids of the edges to copy
+     * @return Graph with original vertex labels
+     */
+    graph to_graph(std::vector<edge_id> const &edges) const;
+};
+
+#endif //MINIMUM_SPANNING_TREE_CSR_GRAPH_H
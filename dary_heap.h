@@ -0,0 +1,129 @@
+#ifndef MINIMUM_SPANNING_TREE_DARY_HEAP_H
+#define MINIMUM_SPANNING_TREE_DARY_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Indexed d-ary min-heap over the ids 0..n-1, each id present at most once.
+ *
+ * Supports decreasing the key of an id that is already in the heap, which is what Prim's algorithm needs.
+ * A larger arity makes the heap shallower: decrease-key gets cheaper and pop-min gets more expensive,
+ * which pays off on dense graphs where decrease-key is by far the most frequent operation.
+ * @tparam Arity Number of children of every node
+ * @tparam Key Key type ordered by operator<
+ * @tparam Allocator Allocator of the keys, rebound for the other arrays
+ */
+template<unsigned Arity, typename Key, typename Allocator = std::allocator<Key>>
+class dary_heap {
+    template<typename T>
+    using rebound = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    static const std::size_t absent = SIZE_MAX;
+
+    std::vector<std::uint32_t, rebound<std::uint32_t>> m_heap;
+    std::vector<Key, Allocator> m_keys;
+    std::vector<std::size_t, rebound<std::size_t>> m_positions;
+
+    inline void place(std::size_t position, std::uint32_t id) {
+        m_heap[position] = id;
+        m_positions[id] = position;
+    }
+
+    void sift_up(std::size_t position) {
+        auto id = m_heap[position];
+
+        while (position > 0) {
+            auto parent = (position - 1) / Arity;
+            if (!(m_keys[id] < m_keys[m_heap[parent]])) break;
+
+            place(position, m_heap[parent]);
+            position = parent;
+        }
+
+        place(position, id);
+    }
+
+    void sift_down(std::size_t position) {
+        auto id = m_heap[position];
+        auto size = m_heap.size();
+
+        while (true) {
+            auto first = position * Arity + 1;
+            if (first >= size) break;
+
+            auto last = first + Arity < size ? first + Arity : size;
+            auto smallest = first;
+
+            for (auto child = first + 1; child < last; child++)
+                if (m_keys[m_heap[child]] < m_keys[m_heap[smallest]]) smallest = child;
+
+            if (!(m_keys[m_heap[smallest]] < m_keys[id])) break;
+
+            place(position, m_heap[smallest]);
+            position = smallest;
+        }
+
+        place(position, id);
+    }
+
+public:
+    /**
+     * @param n Number of ids
+     * @param allocator Allocator of all arrays, which are allocated up front
+     */
+    explicit dary_heap(std::size_t n, Allocator const &allocator = Allocator())
+            : m_heap(allocator), m_keys(n, allocator), m_positions(n, absent, allocator) {
+        m_heap.reserve(n);
+    }
+
+    inline bool empty() const { return m_heap.empty(); }
+    inline bool contains(std::uint32_t id) const { return m_positions[id] != absent; }
+    inline Key const &key(std::uint32_t id) const { return m_keys[id]; }
+
+    /**
+     * Inserts the id, or lowers its key if it is already in the heap and the new key is smaller
+     * @return True if the heap changed
+     */
+    bool push_or_decrease(std::uint32_t id, Key const &key) {
+        if (!contains(id)) {
+            m_keys[id] = key;
+            m_heap.push_back(id);
+            sift_up(m_heap.size() - 1);
+            return true;
+        }
+
+        if (!(key < m_keys[id])) return false;
+
+        m_keys[id] = key;
+        sift_up(m_positions[id]);
+        return true;
+    }
+
+    /**
+     * Removes the id with the smallest key
+     * @return The id
+     */
+    std::uint32_t pop() {
+        auto top = m_heap.front();
+        auto last = m_heap.back();
+
+        m_heap.pop_back();
+        m_positions[top] = absent;
+
+        if (!m_heap.empty()) {
+            place(0, last);
+            sift_down(0);
+        }
+
+        return top;
+    }
+};
+
+template<unsigned Arity, typename Key, typename Allocator>
+const std::size_t dary_heap<Arity, Key, Allocator>::absent;
+
+#endif //MINIMUM_SPANNING_TREE_DARY_HEAP_H
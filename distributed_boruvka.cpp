@@ -0,0 +1,472 @@
+#include "distributed_boruvka.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "union_find.h"
+
+namespace {
+    typedef csr_graph::vertex_id vertex_id;
+    typedef csr_graph::edge_id edge_id;
+
+    /**
+     * Sent instead of an edge count to stop a worker
+     */
+    const std::uint64_t stop_message = UINT64_MAX;
+
+    const std::size_t no_candidate = SIZE_MAX;
+
+    const std::uint32_t no_ghost = UINT32_MAX;
+
+#ifdef MSG_NOSIGNAL
+    // a worker which is gone must not kill the coordinator with SIGPIPE
+    const int send_flags = MSG_NOSIGNAL;
+#else
+    const int send_flags = 0;
+#endif
+
+    /**
+     * Cheapest edge leaving a component among the vertices of one worker
+     */
+    struct candidate_edge {
+        weight_t weight;
+        std::uint32_t component;
+        std::uint32_t other;        // component at the other end of the edge
+        std::uint32_t edge;
+        std::uint32_t reserved;
+    };
+
+    void send_all(int fd, void const *data, std::size_t bytes) {
+        auto next = static_cast<char const *>(data);
+
+        while (bytes > 0) {
+            auto sent = ::send(fd, next, bytes, send_flags);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) throw std::runtime_error("The connection to a worker process is broken");
+
+            next += sent;
+            bytes -= static_cast<std::size_t>(sent);
+        }
+    }
+
+    void receive_all(int fd, void *data, std::size_t bytes) {
+        auto next = static_cast<char *>(data);
+
+        while (bytes > 0) {
+            auto received = ::recv(fd, next, bytes, 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) throw std::runtime_error("A worker process stopped unexpectedly");
+
+            next += received;
+            bytes -= static_cast<std::size_t>(received);
+        }
+    }
+
+    /**
+     * Sends a message: the number of items followed by the items
+     * @param bytes Incremented by the length of the message
+     */
+    template<typename T>
+    void send_message(int fd, T const *items, std::size_t count, std::uint64_t &bytes) {
+        std::uint64_t header = count;
+
+        send_all(fd, &header, sizeof(header));
+        send_all(fd, items, count * sizeof(T));
+        bytes += sizeof(header) + count * sizeof(T);
+    }
+
+    template<typename T>
+    void send_message(int fd, std::vector<T> const &items, std::uint64_t &bytes) {
+        send_message(fd, items.data(), items.size(), bytes);
+    }
+
+    /**
+     * Receives a message of send_message()
+     * @param bytes Incremented by the length of the message
+     * @return False if the message is the stop message
+     */
+    template<typename T>
+    bool receive_message(int fd, std::vector<T> &items, std::uint64_t &bytes) {
+        std::uint64_t count;
+        receive_all(fd, &count, sizeof(count));
+        bytes += sizeof(count);
+
+        if (count == stop_message) return false;
+
+        items.resize(static_cast<std::size_t>(count));
+        receive_all(fd, items.data(), items.size() * sizeof(T));
+        bytes += items.size() * sizeof(T);
+
+        return true;
+    }
+
+    /**
+     * New label of a component merged by the coordinator
+     */
+    struct relabel {
+        std::uint32_t from;
+        std::uint32_t to;
+    };
+
+    /**
+     * Rounds of a worker over the vertices [begin, end) of a graph. The own vertices are numbered 0..owned-1
+     * locally and the ghosts, vertices of other workers at the end of an own edge, after them.
+     * @param offsets Adjacency of the own vertices, relative to the first slot
+     * @param local Local id of the other end of every slot
+     * @param ghosts Global id of every ghost
+     * @param weights Weight of every slot
+     * @param edges Global edge id of every slot
+     */
+    void solve_slice(int fd, vertex_id begin, vertex_id end, std::vector<std::uint64_t> const &offsets,
+                     std::vector<std::uint32_t> &local, std::vector<vertex_id> const &ghosts,
+                     std::vector<weight_t> &weights, std::vector<edge_id> &edges, std::uint64_t &bytes) {
+        auto owned = static_cast<std::size_t>(end - begin);
+        auto local_count = owned + ghosts.size();
+
+        // the local vertices of a component form a set, whose root knows the label of the component; the global id
+        // of a vertex is the label of its initial component
+        union_find sets{local_count};
+        std::vector<std::uint32_t> root_labels(local_count), roots(local_count), labels(local_count);
+
+        for (std::size_t v = 0; v < owned; v++) root_labels[v] = static_cast<std::uint32_t>(begin + v);
+        for (std::size_t i = 0; i < ghosts.size(); i++) root_labels[owned + i] = ghosts[i];
+        for (std::size_t v = 0; v < local_count; v++) roots[v] = static_cast<std::uint32_t>(v);
+        labels = root_labels;
+
+        // end of the live slots of every own vertex, the slots inside a component are dropped for good
+        std::vector<std::uint64_t> ends(offsets.begin() + 1, offsets.end());
+        std::vector<candidate_edge> candidates;
+        std::vector<relabel> merged;
+
+        while (true) {
+            candidates.clear();
+
+            for (std::size_t v = 0; v < owned; v++) {
+                auto c = labels[v];
+                auto best = no_candidate;
+                auto kept = offsets[v];
+
+                for (auto slot = offsets[v]; slot < ends[v]; slot++) {
+                    if (labels[local[slot]] == c) continue;
+
+                    local[kept] = local[slot];
+                    weights[kept] = weights[slot];
+                    edges[kept] = edges[slot];
+
+                    // the order of csr_graph::lighter()
+                    if (best == no_candidate || weights[kept] < weights[best] ||
+                        (weights[kept] == weights[best] && edges[kept] < edges[best]))
+                        best = kept;
+
+                    ++kept;
+                }
+                ends[v] = kept;
+
+                if (best != no_candidate)
+                    candidates.push_back(candidate_edge{weights[best], c, labels[local[best]], edges[best], 0});
+            }
+
+            // the cheapest candidate of every component comes first and is the only one sent
+            std::sort(candidates.begin(), candidates.end(), [](candidate_edge const &x, candidate_edge const &y) {
+                return x.component < y.component ||
+                       (x.component == y.component &&
+                        (x.weight < y.weight || (x.weight == y.weight && x.edge < y.edge)));
+            });
+            candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                         [](candidate_edge const &x, candidate_edge const &y) {
+                                             return x.component == y.component;
+                                         }), candidates.end());
+
+            send_message(fd, candidates, bytes);
+            if (!receive_message(fd, merged, bytes)) return;
+
+            // only the roots are relabeled, the relabels are sorted by the old label
+            for (auto r : roots) {
+                auto it = std::lower_bound(merged.begin(), merged.end(), root_labels[r],
+                                           [](relabel const &x, std::uint32_t label) { return x.from < label; });
+                if (it != merged.end() && it->from == root_labels[r]) root_labels[r] = it->to;
+            }
+
+            // local components which got the same label are merged
+            std::sort(roots.begin(), roots.end(), [&root_labels](std::uint32_t a, std::uint32_t b) {
+                return root_labels[a] < root_labels[b];
+            });
+
+            std::size_t root_count = 0;
+            for (std::size_t i = 0; i < roots.size(); i++) {
+                if (root_count > 0 && root_labels[roots[root_count - 1]] == root_labels[roots[i]]) {
+                    auto label = root_labels[roots[i]];
+                    sets.unite(roots[root_count - 1], roots[i]);
+
+                    roots[root_count - 1] = sets.find(roots[i]);
+                    root_labels[roots[root_count - 1]] = label;
+                } else {
+                    roots[root_count++] = roots[i];
+                }
+            }
+            roots.resize(root_count);
+
+            for (std::size_t v = 0; v < local_count; v++)
+                labels[v] = root_labels[sets.find(static_cast<union_find::id_t>(v))];
+        }
+    }
+
+    /**
+     * Loop of a worker process: receives the slice of a graph, solves it with the coordinator and waits for
+     * the next one until it is stopped
+     */
+    void run_worker(int fd) {
+        std::vector<std::uint64_t> range, offsets;
+        std::vector<std::uint32_t> local;
+        std::vector<vertex_id> ghosts;
+        std::vector<weight_t> weights;
+        std::vector<edge_id> edges;
+        std::uint64_t bytes = 0;
+
+        while (receive_message(fd, range, bytes)) {
+            if (range.size() != 2 || !receive_message(fd, offsets, bytes) || !receive_message(fd, local, bytes) ||
+                !receive_message(fd, ghosts, bytes) || !receive_message(fd, weights, bytes) ||
+                !receive_message(fd, edges, bytes))
+                throw std::runtime_error("The coordinator sent a malformed slice");
+
+            solve_slice(fd, static_cast<vertex_id>(range[0]), static_cast<vertex_id>(range[1]), offsets, local, ghosts,
+                        weights, edges, bytes);
+        }
+    }
+}
+
+/**
+ * Worker processes with the coordinator ends of their sockets
+ */
+struct distributed_boruvka::workers {
+    std::vector<pid_t> pids{};
+    std::vector<int> sockets{};
+};
+
+distributed_boruvka::distributed_boruvka(std::size_t worker_count) : m_workers{std::make_unique<workers>()} {
+    worker_count = std::max<std::size_t>(1, worker_count);
+
+    try {
+        for (std::size_t w = 0; w < worker_count; w++) {
+            int sockets[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+                throw std::runtime_error("Cannot create a socket for a worker process");
+
+            auto pid = ::fork();
+            if (pid < 0) {
+                ::close(sockets[0]);
+                ::close(sockets[1]);
+                throw std::runtime_error("Cannot start a worker process");
+            }
+
+            if (pid == 0) {
+                // the sockets of the other workers stay open only in the coordinator, so they see it close them
+                for (auto fd : m_workers->sockets) ::close(fd);
+                ::close(sockets[0]);
+
+                auto status = 0;
+                try {
+                    run_worker(sockets[1]);
+                } catch (...) {
+                    status = 1;
+                }
+
+                // the copy of the coordinator's state must not be destroyed or flushed twice
+                ::_exit(status);
+            }
+
+            ::close(sockets[1]);
+            m_workers->pids.push_back(pid);
+            m_workers->sockets.push_back(sockets[0]);
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+distributed_boruvka::~distributed_boruvka() {
+    stop();
+}
+
+std::size_t distributed_boruvka::size() const {
+    return m_workers->sockets.size();
+}
+
+void distributed_boruvka::stop() {
+    // a worker waiting for a slice exits on the stop message, any other one when it sees its socket closed
+    for (auto fd : m_workers->sockets) {
+        ::send(fd, &stop_message, sizeof(stop_message), send_flags);
+        ::close(fd);
+    }
+
+    for (auto pid : m_workers->pids) {
+        int status;
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    }
+
+    m_workers->sockets.clear();
+    m_workers->pids.clear();
+}
+
+std::vector<edge_id> distributed_boruvka::solve(csr_graph const &g, bool forest, distributed_summary *summary) {
+    auto const &sockets = m_workers->sockets;
+    if (sockets.empty()) throw std::runtime_error("The worker processes have stopped");
+
+    auto vertex_count = g.vertex_count();
+    auto offsets = g.offsets();
+    auto worker_count = sockets.size();
+
+    union_find sets{vertex_count};
+    std::vector<std::size_t> best(vertex_count, no_candidate);
+    std::vector<vertex_id> touched, merged_labels;
+    std::vector<candidate_edge> candidates, received;
+    std::vector<relabel> merged;
+    std::vector<edge_id> tree;
+    distributed_summary totals{worker_count, 0, 0};
+
+    try {
+        // ranges with about the same number of adjacency slots, a worker may get none on a small graph
+        auto neighbors = g.neighbors();
+        std::vector<std::uint32_t> local, ghost_ids(vertex_count, no_ghost);
+        std::vector<vertex_id> ghosts;
+        vertex_id begin = 0;
+
+        for (std::size_t w = 0; w < worker_count; w++) {
+            auto end = static_cast<vertex_id>(vertex_count);
+            if (w + 1 < worker_count) {
+                auto slots = offsets[vertex_count] / worker_count * (w + 1);
+                end = static_cast<vertex_id>(std::lower_bound(offsets + begin, offsets + vertex_count, slots) - offsets);
+            }
+
+            auto first = offsets[begin], last = offsets[end];
+            std::vector<std::uint64_t> slice_offsets(end - begin + 1);
+            for (std::size_t v = begin; v <= end; v++) slice_offsets[v - begin] = offsets[v] - first;
+
+            // the ghosts are numbered in the order they are met
+            local.resize(last - first);
+            for (auto slot = first; slot < last; slot++) {
+                auto v = neighbors[slot];
+
+                if (v >= begin && v < end) {
+                    local[slot - first] = v - begin;
+                } else {
+                    if (ghost_ids[v] == no_ghost) {
+                        ghost_ids[v] = static_cast<std::uint32_t>(end - begin + ghosts.size());
+                        ghosts.push_back(v);
+                    }
+                    local[slot - first] = ghost_ids[v];
+                }
+            }
+
+            send_message(sockets[w], std::vector<std::uint64_t>{begin, end}, totals.bytes);
+            send_message(sockets[w], slice_offsets, totals.bytes);
+            send_message(sockets[w], local, totals.bytes);
+            send_message(sockets[w], ghosts, totals.bytes);
+            send_message(sockets[w], g.neighbor_weights() + first, last - first, totals.bytes);
+            send_message(sockets[w], g.neighbor_edges() + first, last - first, totals.bytes);
+
+            for (auto v : ghosts) ghost_ids[v] = no_ghost;
+            ghosts.clear();
+            begin = end;
+        }
+
+        // every worker sends its candidates first and then waits, so all of them are read before they are stopped
+        while (true) {
+            candidates.clear();
+            for (auto fd : sockets) {
+                receive_message(fd, received, totals.bytes);
+                candidates.insert(candidates.end(), received.begin(), received.end());
+            }
+
+            // the cheapest candidate of every component in the order of csr_graph::lighter()
+            for (std::size_t i = 0; i < candidates.size(); i++) {
+                auto const &x = candidates[i];
+
+                if (best[x.component] == no_candidate) {
+                    touched.push_back(x.component);
+                    best[x.component] = i;
+                } else {
+                    auto const &y = candidates[best[x.component]];
+                    if (x.weight < y.weight || (x.weight == y.weight && x.edge < y.edge)) best[x.component] = i;
+                }
+            }
+
+            if (touched.empty()) break;
+            ++totals.rounds;
+
+            // an edge chosen by both of its components is committed once
+            std::sort(touched.begin(), touched.end());
+            for (auto c : touched) {
+                auto const &x = candidates[best[c]];
+                if (sets.unite(x.component, x.other)) {
+                    tree.push_back(x.edge);
+                    merged_labels.push_back(x.component);
+                    merged_labels.push_back(x.other);
+                }
+                best[c] = no_candidate;
+            }
+            touched.clear();
+
+            if (sets.set_count() == 1) break;
+
+            // the labels of a round are the roots of its start, only those of merged components change
+            std::sort(merged_labels.begin(), merged_labels.end());
+            merged_labels.erase(std::unique(merged_labels.begin(), merged_labels.end()), merged_labels.end());
+
+            merged.clear();
+            for (auto label : merged_labels) {
+                auto root = sets.find(label);
+                if (root != label) merged.push_back(relabel{label, static_cast<std::uint32_t>(root)});
+            }
+            merged_labels.clear();
+
+            for (auto fd : sockets) send_message(fd, merged, totals.bytes);
+        }
+
+        for (auto fd : sockets) {
+            send_all(fd, &stop_message, sizeof(stop_message));
+            totals.bytes += sizeof(stop_message);
+        }
+    } catch (...) {
+        // the workers are somewhere in the middle of the run and cannot take another graph
+        stop();
+        throw;
+    }
+
+    if (summary != nullptr) *summary = totals;
+
+    if (!forest && sets.set_count() > 1) throw std::domain_error("MST could not be found!");
+
+    return tree;
+}
+
+#else
+
+struct distributed_boruvka::workers {
+};
+
+distributed_boruvka::distributed_boruvka(std::size_t) {
+    throw std::runtime_error("Worker processes need a POSIX system");
+}
+
+distributed_boruvka::~distributed_boruvka() = default;
+
+std::size_t distributed_boruvka::size() const {
+    return 0;
+}
+
+void distributed_boruvka::stop() {}
+
+std::vector<csr_graph::edge_id> distributed_boruvka::solve(csr_graph const &, bool, distributed_summary *) {
+    throw std::runtime_error("Worker processes need a POSIX system");
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef MINIMUM_SPANNING_TREE_DISTRIBUTED_BORUVKA_H
+#define MINIMUM_SPANNING_TREE_DISTRIBUTED_BORUVKA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "csr_graph.h"
+
+struct distributed_summary {
+    std::size_t workers;
+    std::size_t rounds;
+    std::uint64_t bytes;        // sent between the coordinator and the workers
+};
+
+/**
+ * Borůvka's algorithm across worker processes, each of which owns a range of the vertices.
+ *
+ * The workers are forked when the group is created and talk to the calling process over a Unix socket pair each.
+ * A forked child keeps only the thread which forked it, so the group has to be created before the process starts
+ * any other thread, in particular before thread_pool::global() is used (the text loader does).
+ *
+ * solve() splits the vertices into contiguous ranges with about the same number of adjacency slots and sends
+ * every worker only the slots of its range. A worker numbers its own vertices and the ghost vertices at the other
+ * end of its edges locally and keeps the component label of each of them, so it needs memory for its slice only.
+ * In every round each worker sends the cheapest edge (by csr_graph::lighter()) leaving every component it sees,
+ * with the labels of both components. The calling process acts as the coordinator: it keeps the cheapest candidate
+ * of every component, merges the components in its union-find and sends back the new label of every merged
+ * component. The rounds end once no edge leaves a component.
+ */
+class distributed_boruvka {
+    struct workers;
+
+    std::unique_ptr<workers> m_workers;
+
+    /**
+     * Stops the workers and waits for them
+     */
+    void stop();
+
+public:
+    /**
+     * Forks the worker processes
+     * @param worker_count Number of worker processes, at least one
+     * @throws std::runtime_error if a worker cannot be started, or on a system without fork()
+     */
+    explicit distributed_boruvka(std::size_t worker_count);
+    ~distributed_boruvka();
+
+    distributed_boruvka(distributed_boruvka const &) = delete;
+    distributed_boruvka &operator=(distributed_boruvka const &) = delete;
+
+    /**
+     * @return Number of running worker processes
+     */
+    std::size_t size() const;
+
+    /**
+     * Computes the MST of a graph in the workers. A failed run stops the workers.
+     * @param g CSR graph
+     * @param forest True to return the minimum spanning forest of a disconnected graph instead of throwing
+     * @param summary If not null, receives the numbers of the run
+     * @return Ids of the MST edges in the order they were committed
+     * @throws std::domain_error if the graph is not connected and forest is false
+     * @throws std::runtime_error if a worker stops or the workers were stopped by an earlier failure
+     */
+    std::vector<csr_graph::edge_id> solve(csr_graph const &g, bool forest, distributed_summary *summary = nullptr);
+};
+
+#endif //MINIMUM_SPANNING_TREE_DISTRIBUTED_BORUVKA_H
@@ -0,0 +1,250 @@
+#include "dynamic_mst.h"
+#include <algorithm>
+#include <stdexcept>
+#include "union_find.h"
+
+dynamic_mst::dynamic_mst(graph const &g) {
+    std::vector<vertex> labels(g.vertices().begin(), g.vertices().end());
+    for (auto v : labels) vertex_at(v);
+
+    auto dense_id = [&labels](vertex v) {
+        return static_cast<union_find::id_t>(std::lower_bound(labels.begin(), labels.end(), v) - labels.begin());
+    };
+
+    union_find components{labels.size()};
+
+    for (auto const &e : g.edges()) {
+        if (e.start == e.end || m_edges.count(key(e.start, e.end)) != 0) continue;
+
+        auto &r = m_edges[key(e.start, e.end)];
+        r = edge_record{e.start, e.end, e.weight, link_cut_tree::nil};
+
+        if (components.unite(dense_id(e.start), dense_id(e.end)))
+            link_edge(r);
+        else
+            add_other_edge(r);
+    }
+}
+
+dynamic_mst::dynamic_mst(graph const &g, graph const &forest) {
+    for (auto v : g.vertices()) vertex_at(v);
+    for (auto v : forest.vertices()) vertex_at(v);
+
+    for (auto const &e : forest.edges()) {
+        if (e.start == e.end || m_edges.count(key(e.start, e.end)) != 0 ||
+            m_tree.connected(vertex_at(e.start).node, vertex_at(e.end).node))
+            throw std::invalid_argument("The graph is not a forest!");
+
+        auto &r = m_edges[key(e.start, e.end)];
+        r = edge_record{e.start, e.end, e.weight, link_cut_tree::nil};
+        link_edge(r);
+    }
+
+    for (auto const &e : g.edges()) {
+        if (e.start == e.end || m_edges.count(key(e.start, e.end)) != 0) continue;
+
+        auto &r = m_edges[key(e.start, e.end)];
+        r = edge_record{e.start, e.end, e.weight, link_cut_tree::nil};
+        add_other_edge(r);
+    }
+}
+
+dynamic_mst::vertex_record &dynamic_mst::vertex_at(vertex v) {
+    auto it = m_vertices.find(v);
+    if (it != m_vertices.end()) return it->second;
+
+    auto &record = m_vertices[v];
+    record.node = m_tree.add_node(0, false);
+
+    return record;
+}
+
+void dynamic_mst::link_edge(edge_record &r) {
+    auto &start = vertex_at(r.start), &end = vertex_at(r.end);
+
+    r.node = m_tree.add_node(r.weight, true);
+    if (m_node_edges.size() <= r.node) m_node_edges.resize(r.node + 1);
+    m_node_edges[r.node] = key(r.start, r.end);
+
+    m_tree.link(start.node, r.node);
+    m_tree.link(r.node, end.node);
+
+    start.tree_neighbors.insert(r.end);
+    end.tree_neighbors.insert(r.start);
+
+    ++m_tree_edge_count;
+    m_total_weight += r.weight;
+}
+
+void dynamic_mst::cut_edge(edge_record &r) {
+    auto &start = m_vertices[r.start], &end = m_vertices[r.end];
+
+    m_tree.cut(start.node, r.node);
+    m_tree.cut(r.node, end.node);
+    m_tree.remove_node(r.node);
+    r.node = link_cut_tree::nil;
+
+    start.tree_neighbors.erase(r.end);
+    end.tree_neighbors.erase(r.start);
+
+    --m_tree_edge_count;
+    m_total_weight -= r.weight;
+}
+
+void dynamic_mst::add_other_edge(edge_record const &r) {
+    vertex_at(r.start).other_neighbors.insert(r.end);
+    vertex_at(r.end).other_neighbors.insert(r.start);
+}
+
+void dynamic_mst::remove_other_edge(edge_record const &r) {
+    m_vertices[r.start].other_neighbors.erase(r.end);
+    m_vertices[r.end].other_neighbors.erase(r.start);
+}
+
+bool dynamic_mst::connect(edge_record &r) {
+    auto start_node = vertex_at(r.start).node, end_node = vertex_at(r.end).node;
+
+    if (m_tree.connected(start_node, end_node)) {
+        auto heaviest = m_tree.path_max(start_node, end_node);
+
+        if (m_tree.weight(heaviest) <= r.weight) {
+            add_other_edge(r);
+            return false;
+        }
+
+        auto &replaced = m_edges[m_node_edges[heaviest]];
+        cut_edge(replaced);
+        add_other_edge(replaced);
+    }
+
+    link_edge(r);
+    return true;
+}
+
+void dynamic_mst::reconnect(vertex a, vertex b) {
+    // searches both halves in lockstep, so the work stops as soon as the smaller one is complete
+    std::vector<vertex> queues[2] = {{a}, {b}};
+    std::unordered_set<vertex> visited[2] = {{a}, {b}};
+    std::size_t heads[2] = {0, 0};
+    int side = 0;
+
+    while (true) {
+        if (heads[side] == queues[side].size()) break;
+
+        auto v = queues[side][heads[side]++];
+        for (auto u : m_vertices[v].tree_neighbors)
+            if (visited[side].insert(u).second) queues[side].push_back(u);
+
+        side = 1 - side;
+    }
+
+    edge_record *best = nullptr;
+
+    for (auto v : queues[side]) {
+        for (auto u : m_vertices[v].other_neighbors) {
+            if (visited[side].count(u) != 0) continue;
+
+            auto &r = m_edges[key(u, v)];
+            if (best == nullptr || r.weight < best->weight) best = &r;
+        }
+    }
+
+    if (best == nullptr) return;
+
+    remove_other_edge(*best);
+    link_edge(*best);
+}
+
+bool dynamic_mst::insert(edge const &e) {
+    if (e.start == e.end) return false;
+
+    auto it = m_edges.find(key(e.start, e.end));
+    if (it != m_edges.end()) return e.weight < it->second.weight && update_weight(e);
+
+    auto &r = m_edges[key(e.start, e.end)];
+    r = edge_record{e.start, e.end, e.weight, link_cut_tree::nil};
+
+    return connect(r);
+}
+
+bool dynamic_mst::update_weight(edge const &e) {
+    if (e.start == e.end) return false;
+
+    auto it = m_edges.find(key(e.start, e.end));
+    if (it == m_edges.end()) return insert(e);
+
+    auto &r = it->second;
+    auto old_weight = r.weight;
+
+    if (e.weight == old_weight) return false;
+
+    if (r.node == link_cut_tree::nil) {
+        r.weight = e.weight;
+        if (e.weight > old_weight) return false;
+
+        // a lighter non-tree edge may now beat the heaviest edge of its cycle
+        remove_other_edge(r);
+        return connect(r);
+    }
+
+    if (e.weight < old_weight) {
+        // a lighter tree edge stays minimal, the cycle property still holds for every other edge
+        m_tree.set_weight(r.node, e.weight);
+        r.weight = e.weight;
+        m_total_weight -= old_weight - e.weight;
+        return true;
+    }
+
+    // a heavier tree edge competes with the other edges crossing its cut like a deleted one
+    cut_edge(r);
+    r.weight = e.weight;
+    add_other_edge(r);
+    reconnect(r.start, r.end);
+
+    return true;
+}
+
+bool dynamic_mst::erase(vertex a, vertex b) {
+    auto it = m_edges.find(key(a, b));
+    if (it == m_edges.end()) return false;
+
+    auto r = it->second;
+    m_edges.erase(it);
+
+    if (r.node == link_cut_tree::nil) {
+        remove_other_edge(r);
+        return true;
+    }
+
+    cut_edge(r);
+    reconnect(a, b);
+
+    return true;
+}
+
+bool dynamic_mst::in_tree(vertex a, vertex b) const {
+    auto it = m_edges.find(key(a, b));
+    return it != m_edges.end() && it->second.node != link_cut_tree::nil;
+}
+
+graph dynamic_mst::to_graph() const {
+    graph g{};
+
+    for (auto const &entry : m_vertices) g.add_vertex(entry.first);
+
+    for (auto const &entry : m_edges)
+        if (entry.second.node != link_cut_tree::nil)
+            g.add_edge(edge(entry.second.start, entry.second.end, entry.second.weight));
+
+    return g;
+}
+
+graph dynamic_mst::full_graph() const {
+    graph g{};
+
+    for (auto const &entry : m_vertices) g.add_vertex(entry.first);
+
+    for (auto const &entry : m_edges) g.add_edge(edge(entry.second.start, entry.second.end, entry.second.weight));
+
+    return g;
+}
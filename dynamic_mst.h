@@ -0,0 +1,139 @@
+#ifndef MINIMUM_SPANNING_TREE_DYNAMIC_MST_H
+#define MINIMUM_SPANNING_TREE_DYNAMIC_MST_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "edge.h"
+#include "graph.h"
+#include "link_cut_tree.h"
+
+/**
+ * Minimum spanning forest of a graph maintained under edge insertions, deletions and weight changes.
+ *
+ * The forest lives in a link-cut tree with one node per vertex and one per tree edge, the remaining edges
+ * are kept in adjacency sets. A new or lighter edge u-v either joins two trees, or it closes a cycle with
+ * the tree path u..v and replaces the heaviest edge of that path if it is lighter (the cycle property),
+ * which takes one path-maximum query, one cut and one link in O(log n) amortized time.
+ *
+ * Deleting a tree edge (or making it heavier) splits its tree in two, and the lightest non-tree edge
+ * crossing the cut reconnects them (the cut property). Both halves are searched breadth-first in lockstep
+ * until the smaller one is exhausted, then the non-tree edges of the smaller half are scanned, so the cost
+ * is proportional to the smaller half and its degree rather than to the whole graph.
+ */
+class dynamic_mst {
+    typedef link_cut_tree::node_id node_id;
+    typedef std::pair<vertex, vertex> vertex_pair;
+
+    struct vertex_pair_hash {
+        inline std::size_t operator()(vertex_pair const &p) const {
+            return std::hash<vertex>()(p.first * 0x9E3779B97F4A7C15ULL ^ p.second);
+        }
+    };
+
+    /**
+     * Edge of the graph, node is link_cut_tree::nil unless the edge is in the forest
+     */
+    struct edge_record {
+        vertex start;
+        vertex end;
+        weight_t weight;
+        node_id node;
+    };
+
+    struct vertex_record {
+        node_id node;
+        std::unordered_set<vertex> tree_neighbors;
+        std::unordered_set<vertex> other_neighbors;
+    };
+
+    link_cut_tree m_tree{};
+    std::unordered_map<vertex, vertex_record> m_vertices{};
+    std::unordered_map<vertex_pair, edge_record, vertex_pair_hash> m_edges{};
+    std::vector<vertex_pair> m_node_edges{};
+    std::size_t m_tree_edge_count{0};
+    weight_t m_total_weight{0};
+
+    static inline vertex_pair key(vertex a, vertex b) { return a < b ? vertex_pair{a, b} : vertex_pair{b, a}; }
+
+    vertex_record &vertex_at(vertex v);
+    void link_edge(edge_record &r);
+    void cut_edge(edge_record &r);
+    void add_other_edge(edge_record const &r);
+    void remove_other_edge(edge_record const &r);
+
+    /**
+     * Adds an edge which is not in the forest yet, replacing the heaviest edge of the cycle it closes
+     * @return True if the forest has changed
+     */
+    bool connect(edge_record &r);
+
+    /**
+     * Reconnects the trees of a and b, which were split by removing a tree edge between them,
+     * by the lightest non-tree edge crossing the cut
+     */
+    void reconnect(vertex a, vertex b);
+
+public:
+    dynamic_mst() = default;
+
+    /**
+     * Computes the minimum spanning forest of a graph by Kruskal's algorithm,
+     * the edges of a graph already are ordered by weight
+     * @param g The graph, its vertices and edges are copied
+     */
+    explicit dynamic_mst(graph const &g);
+
+    /**
+     * Starts from a graph and its already known minimum spanning forest
+     * @param g The graph
+     * @param forest Minimum spanning forest of g, its edges and vertices are added to g if missing
+     * @throws std::invalid_argument if the forest contains a cycle
+     */
+    dynamic_mst(graph const &g, graph const &forest);
+
+    /**
+     * Inserts an edge, or lowers the weight of an edge which already is in the graph.
+     * A heavier copy of an existing edge changes nothing, unknown vertices are added.
+     * @param e Inserted edge with its new weight
+     * @return True if the forest has changed
+     */
+    bool insert(edge const &e);
+
+    /**
+     * Sets the weight of an edge, inserting it if it is not in the graph
+     * @param e Edge with its new weight
+     * @return True if the forest has changed
+     */
+    bool update_weight(edge const &e);
+
+    /**
+     * Removes the edge between two vertices. If it was a tree edge, the lightest replacement is linked instead.
+     * @return False if there is no such edge
+     */
+    bool erase(vertex a, vertex b);
+
+    /**
+     * @return True if the edge between a and b is a part of the minimum spanning forest
+     */
+    bool in_tree(vertex a, vertex b) const;
+
+    inline weight_t total_weight() const { return m_total_weight; }
+    inline std::size_t vertex_count() const { return m_vertices.size(); }
+    inline std::size_t edge_count() const { return m_edges.size(); }
+    inline std::size_t tree_edge_count() const { return m_tree_edge_count; }
+
+    /**
+     * @return The current minimum spanning forest with the original vertex labels
+     */
+    graph to_graph() const;
+
+    /**
+     * @return The current graph with all of its edges
+     */
+    graph full_graph() const;
+};
+
+#endif //MINIMUM_SPANNING_TREE_DYNAMIC_MST_H
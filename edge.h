@@ -4,13 +4,14 @@
 #include <tuple>
 
 typedef unsigned long vertex;
+typedef unsigned long weight_t;
 
 struct edge {
     const vertex start;
     const vertex end;
-    const unsigned long weight;
+    const weight_t weight;
 
-    constexpr edge(vertex start, vertex end, unsigned long weight) : start{start}, end{end}, weight{weight} {};
+    constexpr edge(vertex start, vertex end, weight_t weight) : start{start}, end{end}, weight{weight} {};
     constexpr edge(edge const &other) = default;
 
     constexpr inline bool operator<(edge const &e) const {
@@ -0,0 +1,235 @@
+#include "external_mst.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "graph_file.h"
+#include "line_parser.h"
+#include "union_find.h"
+
+namespace {
+    const std::size_t stream_buffer_size = 16 << 20;
+    const std::size_t stream_batch_size = 1 << 16;
+
+    /**
+     * Streams the text format block by block, carrying the incomplete last line over to the next block
+     */
+    class text_edge_stream : public edge_stream {
+        std::string m_filename;
+        std::size_t m_vertex_count{0};
+
+    public:
+        explicit text_edge_stream(std::string filename) : m_filename{std::move(filename)} {
+            std::ifstream file(m_filename);
+            std::string header;
+
+            if (!std::getline(file, header)) throw std::runtime_error("Cannot read " + m_filename);
+
+            std::uint64_t vertex_count, edge_count;
+            line_parser line{header.data(), header.data() + header.size()};
+
+            if (!line.read(vertex_count) || !line.read(edge_count) || !line.at_end())
+                throw parse_error(m_filename, 1, "expected <number of vertices> <number of edges>");
+            if (vertex_count > UINT32_MAX)
+                throw parse_error(m_filename, 1, "too many vertices");
+
+            m_vertex_count = static_cast<std::size_t>(vertex_count);
+        }
+
+        inline std::size_t vertex_count() const override { return m_vertex_count; }
+        inline vertex label(std::uint32_t v) const override { return v; }
+
+        void read_all(batch_sink_t const &sink) override {
+            std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::fopen(m_filename.c_str(), "rb"), &std::fclose};
+            if (!file) throw std::runtime_error("Cannot open " + m_filename);
+
+            std::vector<char> buffer(stream_buffer_size);
+            std::vector<stream_edge> batch;
+            batch.reserve(stream_batch_size);
+
+            std::size_t filled = 0, line_number = 0;
+            bool header = true, eof = false;
+
+            while (!eof || filled > 0) {
+                if (!eof) {
+                    // a single line longer than the buffer makes it grow
+                    if (filled == buffer.size()) buffer.resize(2 * buffer.size());
+
+                    auto read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file.get());
+                    filled += read;
+                    eof = read == 0;
+                }
+
+                auto data = buffer.data();
+                auto end = data + filled;
+                auto line_begin = data;
+
+                while (line_begin < end) {
+                    auto line_end = static_cast<char *>(std::memchr(line_begin, '\n', end - line_begin));
+                    if (line_end == nullptr) {
+                        if (!eof) break;
+                        line_end = end; // the last line of the file has no newline
+                    }
+
+                    ++line_number;
+                    line_parser line{line_begin, line_end};
+                    line_begin = line_end + 1;
+
+                    if (header) {
+                        header = false;
+                        continue;
+                    }
+                    if (line.at_end()) continue;
+
+                    std::uint64_t start, count, destination, weight;
+                    if (!line.read(start) || !line.read(count) || start >= m_vertex_count)
+                        throw parse_error(m_filename, line_number, "expected <vertex> <number of edges>");
+
+                    for (std::uint64_t i = 0; i < count; i++) {
+                        if (!line.read(destination) || !line.read(weight) || destination >= m_vertex_count)
+                            throw parse_error(m_filename, line_number, "expected <target vertex> <weight>");
+
+                        batch.push_back(stream_edge{static_cast<std::uint32_t>(start),
+                                                    static_cast<std::uint32_t>(destination),
+                                                    static_cast<weight_t>(weight)});
+
+                        if (batch.size() == stream_batch_size) {
+                            sink(batch.data(), batch.size());
+                            batch.clear();
+                        }
+                    }
+
+                    if (!line.at_end()) throw parse_error(m_filename, line_number, "more edges than announced");
+                }
+
+                auto consumed = static_cast<std::size_t>(std::min(line_begin, end) - data);
+                std::memmove(data, data + consumed, filled - consumed);
+                filled -= consumed;
+            }
+
+            if (!batch.empty()) sink(batch.data(), batch.size());
+        }
+    };
+
+    /**
+     * Streams the source, target and weight arrays of the binary format side by side
+     */
+    class binary_edge_stream : public edge_stream {
+        std::string m_filename;
+        binary_graph_header m_header;
+        std::vector<vertex> m_labels;
+
+        static void read_at(std::ifstream &file, std::size_t position, void *data, std::size_t bytes) {
+            file.seekg(static_cast<std::streamoff>(position));
+            if (!file.read(static_cast<char *>(data), static_cast<std::streamsize>(bytes)))
+                throw std::runtime_error("Cannot read the edges, the file is truncated");
+        }
+
+    public:
+        explicit binary_edge_stream(std::string filename)
+                : m_filename{std::move(filename)}, m_header(read_binary_graph_header(m_filename)) {
+            // the labels take O(V) memory like the rest of the resident state
+            std::ifstream file(m_filename, std::ios::in | std::ios::binary);
+            binary_graph_layout layout{m_header.vertex_count, m_header.edge_count};
+
+            m_labels.resize(m_header.vertex_count);
+            read_at(file, layout.labels, m_labels.data(), m_labels.size() * sizeof(vertex));
+        }
+
+        inline std::size_t vertex_count() const override { return m_labels.size(); }
+        inline vertex label(std::uint32_t v) const override { return m_labels[v]; }
+
+        void read_all(batch_sink_t const &sink) override {
+            std::ifstream file(m_filename, std::ios::in | std::ios::binary);
+            if (!file) throw std::runtime_error("Cannot open " + m_filename);
+
+            binary_graph_layout layout{m_header.vertex_count, m_header.edge_count};
+            auto edge_count = static_cast<std::size_t>(m_header.edge_count);
+
+            std::vector<std::uint32_t> sources(stream_batch_size), targets(stream_batch_size);
+            std::vector<weight_t> weights(stream_batch_size);
+            std::vector<stream_edge> batch(stream_batch_size);
+
+            for (std::size_t first = 0; first < edge_count; first += stream_batch_size) {
+                auto count = std::min(stream_batch_size, edge_count - first);
+
+                read_at(file, layout.sources + first * 4, sources.data(), count * 4);
+                read_at(file, layout.targets + first * 4, targets.data(), count * 4);
+                read_at(file, layout.weights + first * 8, weights.data(), count * 8);
+
+                for (std::size_t i = 0; i < count; i++) batch[i] = stream_edge{sources[i], targets[i], weights[i]};
+
+                sink(batch.data(), count);
+            }
+        }
+    };
+
+    /**
+     * Orders edges by (weight, smaller endpoint, larger endpoint). A self-loop marks a missing edge.
+     */
+    inline bool lighter(stream_edge const &a, stream_edge const &b) {
+        if (b.source == b.target) return true;
+        if (a.weight != b.weight) return a.weight < b.weight;
+
+        auto a_low = std::min(a.source, a.target), b_low = std::min(b.source, b.target);
+        if (a_low != b_low) return a_low < b_low;
+
+        return std::max(a.source, a.target) < std::max(b.source, b.target);
+    }
+}
+
+std::unique_ptr<edge_stream> open_edge_stream(std::string const &filename) {
+    if (is_binary_graph_file(filename)) return std::make_unique<binary_edge_stream>(filename);
+    return std::make_unique<text_edge_stream>(filename);
+}
+
+external_mst_summary calculate_external_mst(edge_stream &edges, std::ostream &output) {
+    auto vertex_count = edges.vertex_count();
+
+    union_find sets{vertex_count};
+    std::vector<stream_edge> cheapest(vertex_count, stream_edge{0, 0, 0});
+
+    external_mst_summary summary{vertex_count, 0, 0, 0};
+
+    while (sets.set_count() > 1) {
+        ++summary.passes;
+
+        edges.read_all([&](stream_edge const *batch, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                auto const &e = batch[i];
+                auto a = sets.find(e.source), b = sets.find(e.target);
+                if (a == b) continue;
+
+                if (lighter(e, cheapest[a])) cheapest[a] = e;
+                if (lighter(e, cheapest[b])) cheapest[b] = e;
+            }
+        });
+
+        std::size_t added = 0;
+
+        for (auto &e : cheapest) {
+            if (e.source == e.target) continue;
+
+            // both components may have picked the same edge, the union-find filters the duplicate out
+            if (sets.unite(e.source, e.target)) {
+                output << edges.label(e.source) << ' ' << edges.label(e.target) << ' ' << e.weight << '\n';
+                summary.total_weight += e.weight;
+                ++added;
+            }
+
+            e = stream_edge{0, 0, 0};
+        }
+
+        summary.tree_edges += added;
+
+        if (added == 0) break; // no edge leaves any component, the graph is not connected
+    }
+
+    output.flush();
+
+    if (sets.set_count() > 1) throw std::domain_error("MST could not be found!");
+
+    return summary;
+}
@@ -0,0 +1,76 @@
+#ifndef MINIMUM_SPANNING_TREE_EXTERNAL_MST_H
+#define MINIMUM_SPANNING_TREE_EXTERNAL_MST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "edge.h"
+
+/**
+ * Edge read from a stream, the endpoints are dense vertex ids
+ */
+struct stream_edge {
+    std::uint32_t source;
+    std::uint32_t target;
+    weight_t weight;
+};
+
+/**
+ * Sequential reader of the edges of a graph file which keeps only a fixed-size buffer in memory
+ */
+class edge_stream {
+public:
+    typedef std::function<void(stream_edge const *, std::size_t)> batch_sink_t;
+
+    virtual ~edge_stream() = default;
+
+    virtual std::size_t vertex_count() const = 0;
+
+    /**
+     * @param v Dense vertex id
+     * @return Original label of the vertex
+     */
+    virtual vertex label(std::uint32_t v) const = 0;
+
+    /**
+     * Reads the file from the beginning and passes all of its edges to the sink in batches
+     * @param sink Callable receiving a pointer to the batch and its length
+     */
+    virtual void read_all(batch_sink_t const &sink) = 0;
+};
+
+/**
+ * Opens a graph file for streaming, the format is recognized by the magic at the start of the file.
+ * Text files yield every edge once per line listing it, binary files once.
+ * @param filename Path to the file
+ * @return The stream
+ * @throws std::runtime_error if the file cannot be opened
+ */
+std::unique_ptr<edge_stream> open_edge_stream(std::string const &filename);
+
+struct external_mst_summary {
+    std::size_t vertex_count;
+    std::size_t tree_edges;
+    std::size_t passes;
+    unsigned long long total_weight;
+};
+
+/**
+ * Semi-external Borůvka's algorithm for graphs whose edges do not fit into memory.
+ *
+ * Only O(V) state stays resident: a union-find over the vertices and the cheapest known edge of every
+ * component. Every pass streams all edges from the disk once and updates the cheapest edges, then the
+ * cheapest edges are committed, merging the components, and written to the output right away.
+ * At least half of the components disappear with every pass, so there are at most log2(V) passes.
+ * Ties are broken by (weight, smaller endpoint, larger endpoint).
+ * @param edges Edge stream
+ * @param output Receives a "<start> <end> <weight>" line for every MST edge as soon as it is committed
+ * @return Summary of the run
+ * @throws std::domain_error if the graph is not connected, after its spanning forest has been written
+ */
+external_mst_summary calculate_external_mst(edge_stream &edges, std::ostream &output);
+
+#endif //MINIMUM_SPANNING_TREE_EXTERNAL_MST_H
@@ -9,6 +9,9 @@
 #include <vector>
 #include "edge.h"
 
+class csr_graph;
+class thread_pool;
+
 typedef std::set<edge> edges_t;
 typedef std::set<vertex> vertices_t;
 typedef vertices_t component_t;
@@ -22,32 +25,28 @@ class graph {
 
     /**
      * Returns a set of all components in the graph. Component is a set of connected vertices,
-     * i.e. there is a path from every vertex to any other vertex via graph edges
+     * i.e. there is a path from every vertex to any other vertex via graph edges.
+     * Found by connected_components() on a CSR copy of the graph.
+     * @param pool Pool linking the vertices, nullptr runs in the calling thread
      * @return Set of components
      */
-    components_t get_components() const;
+    components_t get_components(thread_pool *pool) const;
+    inline components_t get_components() const { return get_components(nullptr); }
     components_t get_components_parallel() const;
 
-    std::map<vertex, vertices_t> const get_component_by_vertex(components_t const &components) const;
-
-    /**
-     * Returns all vertices connected to a certain vertex by looking in the edges_by_vertex map
-     *
-     * Note: because the search is recursive and repetitions and loops may occur,
-     * we need to keep track of all the vertices. That's why we pass the resulting set as an argument
-     * instead of having it as a return value.
-     * @param map
-     * @param v
-     * @param ret
-     */
-    void populate_set_with_connected_vertices(vertex_to_edges_map const &map, vertex v, vertices_t &ret) const;
-
 public:
     graph() = default;
 
     inline std::pair<edges_t::iterator, bool> add_edge(const edge &e) { return m_edges.insert(e); }
     inline std::pair<vertices_t::iterator, bool> add_vertex(vertex v) { return m_vertices.insert(v); }
 
+    /**
+     * Removes an edge in either direction. The weight has to match, because edges are ordered by it.
+     * @param e Edge to remove
+     * @return True if the edge was in the graph
+     */
+    bool remove_edge(edge const &e);
+
     inline edges_t const &edges() const { return m_edges; }
     inline vertices_t const &vertices() const { return m_vertices; }
 
@@ -68,14 +67,32 @@ public:
 
     /**
      * Checks if the graph is connected (i.e. if there are no separated vertices).
-     * Gets graph components and checks if the size is equal to one.
+     * Counts the components with connected_components() and checks if there is exactly one.
      * @return True if the graph is connected
      */
-    inline bool is_connected() const { return get_components().size() == 1; }
+    bool is_connected() const;
     bool has_edge(edge const &e) const;
 
     graph calculate_minimum_spanning_tree() const;
     std::unique_ptr<graph> calculate_minimum_spanning_tree_parallel() const;
+
+    /**
+     * Runs Borůvka's algorithm directly on a CSR graph, so the graph can be converted once and reused.
+     * The no-argument overloads convert this graph and call these, the parallel one with thread_pool::global().
+     * @param g CSR graph
+     * @param pool Pool executing the parallel parts
+     * @return MST with the original vertex labels
+     */
+    static graph calculate_minimum_spanning_tree(csr_graph const &g);
+    static std::unique_ptr<graph> calculate_minimum_spanning_tree_parallel(csr_graph const &g, thread_pool &pool);
+
+    /**
+     * Treats this graph as a minimum spanning tree (or forest) and updates it for a batch of inserted edges
+     * or decreased weights, without recomputing it from scratch. See dynamic_mst.
+     * @param updates Inserted edges, an edge which already is in the tree with a lower weight decreases it
+     * @return The updated MST
+     */
+    graph update_minimum_spanning_tree(std::vector<edge> const &updates) const;
 };
 
 #endif //MINIMUM_SPANNING_TREE_GRAPH_H
@@ -0,0 +1,386 @@
+#include "graph_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "line_parser.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+static_assert(sizeof(vertex) == 8 && sizeof(std::size_t) == 8 && sizeof(weight_t) == 8,
+              "The binary graph format stores labels, offsets and weights as 64-bit numbers");
+static_assert(sizeof(csr_graph::vertex_id) == 4 && sizeof(csr_graph::edge_id) == 4,
+              "The binary graph format stores vertex and edge ids as 32-bit numbers");
+
+namespace {
+    const char binary_magic[8] = {'M', 'S', 'T', 'G', 'R', 'A', 'P', 'H'};
+    const std::uint32_t binary_version = 1;
+    const std::uint64_t byte_order_mark = 0x0102030405060708ULL;
+
+    inline std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+    void validate_header(binary_graph_header const &header, std::string const &filename) {
+        if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0)
+            throw std::runtime_error(filename + " is not a binary graph file");
+        if (header.version != binary_version || header.header_size != sizeof(binary_graph_header))
+            throw std::runtime_error(filename + " has unsupported version " + std::to_string(header.version));
+        if (header.byte_order != byte_order_mark)
+            throw std::runtime_error(filename + " was written on a machine with a different byte order");
+        if (header.vertex_count > UINT32_MAX || header.edge_count >= csr_graph::no_edge)
+            throw std::runtime_error(filename + " is corrupted (the graph is too large)");
+    }
+
+    /**
+     * Mixes 8-byte words into a running hash. Every array is padded to whole words, so the checksum of a file
+     * is the same whether it is computed in one go or array by array.
+     */
+    std::uint64_t checksum_words(std::uint64_t hash, char const *data, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+
+            hash ^= word;
+            hash = (hash << 31) | (hash >> 33);
+            hash *= 0x9E3779B97F4A7C15ULL;
+        }
+        return hash;
+    }
+
+    /**
+     * Chunks of a text file shorter than this are not worth a separate task
+     */
+    const std::size_t min_text_chunk_size = 1 << 20;
+
+    /**
+     * Edge read from a text file with the smaller endpoint in the high half of the key
+     */
+    struct text_edge {
+        std::uint64_t key;
+        weight_t weight;
+    };
+
+    /**
+     * Edges parsed from one chunk of a text file, already scattered into buckets
+     */
+    struct text_chunk {
+        char const *begin;
+        char const *end;
+        std::vector<std::vector<text_edge>> buckets{};
+        std::size_t lines{0};
+        std::size_t error_line{0};  // index of the malformed line within the chunk
+        std::string error{};
+    };
+
+    /**
+     * Parses the vertex lines of a chunk. Stops at the first malformed line and records it in the chunk.
+     */
+    void parse_text_chunk(text_chunk &chunk, std::uint64_t vertex_count, std::size_t bucket_count) {
+        chunk.buckets.resize(bucket_count);
+
+        auto fail = [&chunk](std::string const &message) {
+            chunk.error_line = chunk.lines - 1;
+            chunk.error = message;
+        };
+
+        for (auto line_begin = chunk.begin; line_begin < chunk.end;) {
+            auto line_end = static_cast<char const *>(std::memchr(line_begin, '\n', chunk.end - line_begin));
+            if (line_end == nullptr) line_end = chunk.end;
+
+            ++chunk.lines;
+            line_parser line{line_begin, line_end};
+            line_begin = line_end + 1;
+
+            if (line.at_end()) continue; // blank lines are allowed
+
+            std::uint64_t start, count;
+            if (!line.read(start) || !line.read(count)) return fail("expected <vertex> <number of edges>");
+            if (start >= vertex_count) return fail("vertex " + std::to_string(start) + " is out of range");
+
+            for (std::uint64_t i = 0; i < count; i++) {
+                std::uint64_t destination, weight;
+
+                if (!line.read(destination) || !line.read(weight))
+                    return fail("expected <target vertex> <weight> of edge " + std::to_string(i + 1) +
+                                " of " + std::to_string(count));
+                if (destination >= vertex_count)
+                    return fail("vertex " + std::to_string(destination) + " is out of range");
+
+                auto low = std::min(start, destination), high = std::max(start, destination);
+                auto bucket = static_cast<std::size_t>(low * bucket_count / vertex_count);
+
+                chunk.buckets[bucket].push_back(text_edge{(low << 32) | high, static_cast<weight_t>(weight)});
+            }
+
+            if (!line.at_end()) return fail("more than " + std::to_string(count) + " edges");
+        }
+    }
+
+    /**
+     * Writes one array padded to whole words and folds it into the checksum
+     */
+    void write_section(std::ofstream &file, std::uint64_t &checksum, void const *data, std::size_t bytes) {
+        static const char zeros[8] = {};
+
+        auto remainder = padded(bytes) - bytes;
+        auto full = bytes - bytes % 8;
+
+        file.write(static_cast<char const *>(data), static_cast<std::streamsize>(bytes));
+        file.write(zeros, static_cast<std::streamsize>(remainder));
+
+        checksum = checksum_words(checksum, static_cast<char const *>(data), full);
+
+        if (remainder > 0) {
+            char last[8] = {};
+            std::memcpy(last, static_cast<char const *>(data) + full, bytes - full);
+            checksum = checksum_words(checksum, last, 8);
+        }
+    }
+}
+
+binary_graph_layout::binary_graph_layout(std::uint64_t n, std::uint64_t m) {
+    labels = sizeof(binary_graph_header);
+    offsets = labels + padded(n * 8);
+    neighbors = offsets + padded((n + 1) * 8);
+    neighbor_edges = neighbors + padded(2 * m * 4);
+    neighbor_weights = neighbor_edges + padded(2 * m * 4);
+    sources = neighbor_weights + padded(2 * m * 8);
+    targets = sources + padded(m * 4);
+    weights = targets + padded(m * 4);
+    end = weights + padded(m * 8);
+}
+
+binary_graph_header read_binary_graph_header(std::string const &filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    binary_graph_header header{};
+
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        throw std::runtime_error(filename + " is not a binary graph file");
+
+    validate_header(header, filename);
+
+    return header;
+}
+
+bool is_binary_graph_file(std::string const &filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    char magic[sizeof(binary_magic)];
+
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, binary_magic, sizeof(magic)) == 0;
+}
+
+void save_binary_graph(csr_graph const &g, std::string const &filename) {
+    std::vector<char> buffer(1 << 20);
+    std::ofstream file;
+
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open " + filename + " for writing");
+
+    auto n = g.vertex_count(), m = g.edge_count();
+
+    binary_graph_header header{};
+    std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+    header.version = binary_version;
+    header.header_size = sizeof(binary_graph_header);
+    header.byte_order = byte_order_mark;
+    header.vertex_count = n;
+    header.edge_count = m;
+
+    // the checksum is known only at the end, so the header is written twice
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+    std::uint64_t checksum = 0;
+    write_section(file, checksum, g.labels(), n * 8);
+    write_section(file, checksum, g.offsets(), (n + 1) * 8);
+    write_section(file, checksum, g.neighbors(), 2 * m * 4);
+    write_section(file, checksum, g.neighbor_edges(), 2 * m * 4);
+    write_section(file, checksum, g.neighbor_weights(), 2 * m * 8);
+    write_section(file, checksum, g.sources(), m * 4);
+    write_section(file, checksum, g.targets(), m * 4);
+    write_section(file, checksum, g.weights(), m * 8);
+
+    header.checksum = checksum;
+    file.seekp(0);
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+    if (!file.flush()) throw std::runtime_error("Cannot write " + filename);
+}
+
+csr_graph load_binary_graph(std::string const &filename, bool verify_checksum) {
+    auto file = std::make_shared<mapped_file>(filename);
+    auto data = file->data();
+
+    binary_graph_header header{};
+    if (file->size() < sizeof(header)) throw std::runtime_error(filename + " is not a binary graph file");
+    std::memcpy(&header, data, sizeof(header));
+
+    validate_header(header, filename);
+
+    auto n = header.vertex_count, m = header.edge_count;
+
+    binary_graph_layout layout{n, m};
+    if (file->size() != layout.end) throw std::runtime_error(filename + " is corrupted (wrong size)");
+
+    if (verify_checksum) {
+        file->advise_sequential();
+        auto checksum = checksum_words(0, data + layout.labels, layout.end - layout.labels);
+        if (checksum != header.checksum) throw std::runtime_error(filename + " is corrupted (checksum mismatch)");
+    }
+
+    csr_graph::arrays arrays{
+            static_cast<std::size_t>(n), static_cast<std::size_t>(m),
+            reinterpret_cast<vertex const *>(data + layout.labels),
+            reinterpret_cast<std::size_t const *>(data + layout.offsets),
+            reinterpret_cast<csr_graph::vertex_id const *>(data + layout.neighbors),
+            reinterpret_cast<weight_t const *>(data + layout.neighbor_weights),
+            reinterpret_cast<csr_graph::edge_id const *>(data + layout.neighbor_edges),
+            reinterpret_cast<csr_graph::vertex_id const *>(data + layout.sources),
+            reinterpret_cast<csr_graph::vertex_id const *>(data + layout.targets),
+            reinterpret_cast<weight_t const *>(data + layout.weights)
+    };
+
+    if (arrays.offsets[n] != 2 * m) throw std::runtime_error(filename + " is corrupted (inconsistent offsets)");
+
+    return csr_graph(arrays, std::move(file));
+}
+
+csr_graph load_text_graph(std::string const &filename, thread_pool *pool) {
+    mapped_file file{filename};
+    file.advise_sequential();
+
+    auto data = file.data(), end = data + file.size();
+
+    auto header_end = static_cast<char const *>(std::memchr(data, '\n', file.size()));
+    if (header_end == nullptr) header_end = end;
+
+    std::uint64_t vertex_count, edge_count;
+    line_parser header{data, header_end};
+
+    if (!header.read(vertex_count) || !header.read(edge_count) || !header.at_end())
+        throw parse_error(filename, 1, "expected <number of vertices> <number of edges>");
+    if (vertex_count > UINT32_MAX)
+        throw parse_error(filename, 1, "too many vertices for the CSR representation");
+
+    auto body = header_end < end ? header_end + 1 : end;
+    auto body_size = static_cast<std::size_t>(end - body);
+
+    // splits the body into chunks starting at the beginning of a line
+    auto chunk_count = pool == nullptr ? 1 : std::max<std::size_t>(1, std::min(body_size / min_text_chunk_size,
+                                                                              4 * pool->size()));
+    std::vector<text_chunk> chunks;
+    chunks.reserve(chunk_count);
+
+    for (std::size_t i = 0, position = 0; i < chunk_count; i++) {
+        auto chunk_end = i + 1 == chunk_count ? body_size : std::max(position, (i + 1) * body_size / chunk_count);
+
+        if (chunk_end < body_size) {
+            auto newline = std::memchr(body + chunk_end, '\n', body_size - chunk_end);
+            chunk_end = newline == nullptr ? body_size : static_cast<char const *>(newline) - body + 1;
+        }
+
+        chunks.push_back(text_chunk{body + position, body + chunk_end});
+        position = chunk_end;
+    }
+
+    // every chunk scatters its edges into the same buckets by the smaller endpoint,
+    // so all copies of an edge end up in one bucket no matter which lines they come from;
+    // the buckets are on the heap, an arena could not serve the chunks filling them in parallel
+    auto bucket_count = chunk_count;
+
+    for_each_task(pool, chunk_count, [&](std::size_t i) { parse_text_chunk(chunks[i], vertex_count, bucket_count); });
+
+    std::size_t line = 1;
+    for (auto const &chunk : chunks) {
+        if (!chunk.error.empty()) throw parse_error(filename, line + chunk.error_line + 1, chunk.error);
+        line += chunk.lines;
+    }
+
+    // sorting by key is stable, so chunks merged in file order keep the first occurrence of every edge first
+    std::vector<std::vector<text_edge>> buckets(bucket_count);
+
+    for_each_task(pool, bucket_count, [&](std::size_t b) {
+        auto &bucket = buckets[b];
+
+        std::size_t size = 0;
+        for (auto const &chunk : chunks) size += chunk.buckets[b].size();
+        bucket.reserve(size);
+
+        for (auto &chunk : chunks) {
+            bucket.insert(bucket.end(), chunk.buckets[b].begin(), chunk.buckets[b].end());
+            std::vector<text_edge>().swap(chunk.buckets[b]);
+        }
+
+        std::stable_sort(bucket.begin(), bucket.end(), [](text_edge const &a, text_edge const &b) {
+            return a.key < b.key;
+        });
+        bucket.erase(std::unique(bucket.begin(), bucket.end(), [](text_edge const &a, text_edge const &b) {
+            return a.key == b.key;
+        }), bucket.end());
+    });
+
+    std::vector<std::size_t> bucket_offsets(bucket_count + 1, 0);
+    for (std::size_t b = 0; b < bucket_count; b++) bucket_offsets[b + 1] = bucket_offsets[b] + buckets[b].size();
+
+    auto unique_edges = bucket_offsets[bucket_count];
+    if (unique_edges >= csr_graph::no_edge) throw std::runtime_error(filename + " has too many edges");
+
+    std::vector<vertex> labels(vertex_count);
+    std::vector<csr_graph::vertex_id> sources(unique_edges), targets(unique_edges);
+    std::vector<weight_t> weights(unique_edges);
+
+    for (std::size_t v = 0; v < labels.size(); v++) labels[v] = v;
+
+    for_each_task(pool, bucket_count, [&](std::size_t b) {
+        auto position = bucket_offsets[b];
+
+        for (auto const &e : buckets[b]) {
+            sources[position] = static_cast<csr_graph::vertex_id>(e.key >> 32);
+            targets[position] = static_cast<csr_graph::vertex_id>(e.key & UINT32_MAX);
+            weights[position] = e.weight;
+            ++position;
+        }
+
+        std::vector<text_edge>().swap(buckets[b]);
+    });
+
+    return csr_graph(std::move(labels), std::move(sources), std::move(targets), std::move(weights));
+}
+
+std::vector<edge_update> load_edge_updates(std::string const &filename) {
+    mapped_file file{filename};
+    file.advise_sequential();
+
+    std::vector<edge_update> updates;
+
+    auto data = file.data(), end = data + file.size();
+    std::size_t line_number = 0;
+
+    while (data < end) {
+        auto line_end = static_cast<char const *>(std::memchr(data, '\n', static_cast<std::size_t>(end - data)));
+        if (line_end == nullptr) line_end = end;
+        ++line_number;
+
+        line_parser line{data, line_end};
+        data = line_end + 1;
+
+        if (line.at_end()) continue;
+
+        std::uint64_t start, target, weight = 0;
+
+        if (line.skip('-')) {
+            if (!line.read(start) || !line.read(target) || !line.at_end())
+                throw parse_error(filename, line_number, "expected - <start> <end>");
+
+            updates.push_back(edge_update{edge(start, target, 0), true});
+        } else {
+            if (!line.read(start) || !line.read(target) || !line.read(weight) || !line.at_end())
+                throw parse_error(filename, line_number, "expected <start> <end> <weight>");
+
+            updates.push_back(edge_update{edge(start, target, weight), false});
+        }
+    }
+
+    return updates;
+}
@@ -0,0 +1,127 @@
+#ifndef MINIMUM_SPANNING_TREE_GRAPH_FILE_H
+#define MINIMUM_SPANNING_TREE_GRAPH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+class thread_pool;
+
+/**
+ * Malformed line in a text graph file
+ */
+class parse_error : public std::runtime_error {
+    std::size_t m_line;
+
+public:
+    parse_error(std::string const &filename, std::size_t line, std::string const &message)
+            : std::runtime_error(filename + ":" + std::to_string(line) + ": " + message), m_line{line} {}
+
+    inline std::size_t line() const { return m_line; }
+};
+
+/**
+ * Loads a graph in the text format described in the README:
+ * a header line "<vertex count> <edge count>" followed by one line per vertex
+ * "<vertex> <edge count> <target> <weight> <target> <weight> ...".
+ *
+ * The file is memory-mapped and split at line boundaries into one chunk per task. The chunks are parsed
+ * in parallel with a hand-rolled integer parser, every edge is normalized to (smaller id, larger id) and
+ * scattered into buckets by its smaller endpoint. Each bucket is then sorted and deduplicated on its own,
+ * which removes the reverse-direction copy of every edge; when an edge appears with different weights,
+ * its first occurrence in the file wins.
+ * @param filename Path to the file
+ * @param pool Pool parsing the chunks and processing the buckets, nullptr parses in the calling thread
+ * @return CSR graph with vertices labeled 0..n-1
+ * @throws parse_error for the first malformed line of the file
+ * @throws std::runtime_error if the file cannot be read
+ */
+csr_graph load_text_graph(std::string const &filename, thread_pool *pool);
+
+/**
+ * Change of one edge read from a delta file
+ */
+struct edge_update {
+    edge e;         // the weight is meaningless for deletions
+    bool erase;
+};
+
+/**
+ * Loads a delta file with one change per line: "<start> <end> <weight>" inserts an edge or sets its weight,
+ * "- <start> <end>" deletes it. Empty lines are skipped.
+ * @param filename Path to the file
+ * @return Changes in the order of the file
+ * @throws parse_error for the first malformed line of the file
+ * @throws std::runtime_error if the file cannot be read
+ */
+std::vector<edge_update> load_edge_updates(std::string const &filename);
+
+/**
+ * Binary graph file format, version 1.
+ *
+ * The file is a 64-byte header followed by the arrays of a csr_graph in this order:
+ * labels (n x u64), offsets ((n + 1) x u64), neighbors (2m x u32), neighbor edges (2m x u32),
+ * neighbor weights (2m x u64), sources (m x u32), targets (m x u32), weights (m x u64).
+ * Every array starts at a multiple of 8 bytes (padded with zeros), so once the file is memory-mapped
+ * the arrays are used in place without any parsing or copying. Numbers are stored in the native byte order,
+ * which the header records so that a file written on a machine with a different one is rejected.
+ */
+struct binary_graph_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t byte_order;
+    std::uint64_t vertex_count;
+    std::uint64_t edge_count;
+    std::uint64_t checksum;     // of all bytes following the header
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(binary_graph_header) == 64, "The binary graph header must be 64 bytes long");
+
+/**
+ * Byte offset of every array in a binary graph file, derived from the vertex and edge counts
+ */
+struct binary_graph_layout {
+    std::size_t labels, offsets, neighbors, neighbor_edges, neighbor_weights, sources, targets, weights, end;
+
+    binary_graph_layout(std::uint64_t n, std::uint64_t m);
+};
+
+/**
+ * Reads and validates the header of a binary graph file without reading the rest of the file
+ * @param filename Path to the file
+ * @return The header
+ * @throws std::runtime_error if the file is not a binary graph file of a supported version
+ */
+binary_graph_header read_binary_graph_header(std::string const &filename);
+
+/**
+ * Checks if a file starts with the magic of the binary graph format
+ * @param filename Path to the file
+ * @return True if the file is a binary graph file
+ */
+bool is_binary_graph_file(std::string const &filename);
+
+/**
+ * Writes a graph in the binary format
+ * @param g Graph to save
+ * @param filename Path to the file
+ * @throws std::runtime_error if the file cannot be written
+ */
+void save_binary_graph(csr_graph const &g, std::string const &filename);
+
+/**
+ * Memory-maps a binary graph file and wraps its arrays without copying them.
+ * The mapping lives as long as the returned graph or any of its copies.
+ * @param filename Path to the file
+ * @param verify_checksum Reads the whole file once to compare its checksum with the header
+ * @return Graph backed by the mapped file
+ * @throws std::runtime_error if the file is not a valid binary graph file
+ */
+csr_graph load_binary_graph(std::string const &filename, bool verify_checksum = true);
+
+#endif //MINIMUM_SPANNING_TREE_GRAPH_FILE_H
@@ -0,0 +1,659 @@
+#include "graph_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include "graph_file.h"
+#include "thread_pool.h"
+
+namespace {
+    /**
+     * Number of edges drawn by one block, each block has its own random number generator
+     */
+    const std::size_t generator_block_size = 1 << 20;
+
+    /**
+     * Average number of edges per bucket
+     */
+    const std::size_t generator_bucket_size = 1 << 16;
+
+    /**
+     * Round of the seeds of the trimming and of the weights of the enumerated pairs, the drawing rounds count up
+     * from 2 and never get there
+     */
+    const std::uint64_t trim_round = 0xFFFFFE, complement_round = 0xFFFFFF;
+
+    /**
+     * Finalizer of SplitMix64, turns similar numbers into unrelated ones
+     */
+    inline std::uint64_t mix(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    inline std::uint64_t block_seed(std::uint64_t seed, std::uint64_t round, std::uint64_t block) {
+        return mix(seed ^ mix((round << 40) + block));
+    }
+
+    /**
+     * Generated edge with the smaller endpoint in the high half of the key
+     */
+    struct generated_edge {
+        std::uint64_t key;
+        weight_t weight;
+    };
+
+    inline std::uint64_t edge_key(std::uint64_t a, std::uint64_t b) { return a < b ? a << 32 | b : b << 32 | a; }
+
+    /**
+     * Open-addressing hash set of edge keys with linear probing. Zero marks an empty slot,
+     * which is never a key because the larger endpoint of an edge is never zero.
+     */
+    class key_set {
+        std::vector<std::uint64_t> m_slots;
+        std::size_t m_size{0};
+
+        inline std::size_t slot(std::uint64_t key) const { return mix(key) & (m_slots.size() - 1); }
+
+        void grow() {
+            std::vector<std::uint64_t> old(std::max<std::size_t>(16, 2 * m_slots.size()), 0);
+            old.swap(m_slots);
+
+            for (auto key : old) {
+                if (key == 0) continue;
+
+                auto i = slot(key);
+                while (m_slots[i] != 0) i = (i + 1) & (m_slots.size() - 1);
+                m_slots[i] = key;
+            }
+        }
+
+    public:
+        /**
+         * @return False if the key was already there
+         */
+        bool insert(std::uint64_t key) {
+            if (10 * (m_size + 1) > 7 * m_slots.size()) grow();
+
+            auto i = slot(key);
+            while (m_slots[i] != 0) {
+                if (m_slots[i] == key) return false;
+                i = (i + 1) & (m_slots.size() - 1);
+            }
+
+            m_slots[i] = key;
+            ++m_size;
+            return true;
+        }
+
+        void clear() { std::vector<std::uint64_t>().swap(m_slots); m_size = 0; }
+    };
+
+    /**
+     * Draws weights from the configured distribution
+     */
+    class weight_generator {
+        generator_options const &m_options;
+        std::uniform_int_distribution<weight_t> m_uniform;
+        std::normal_distribution<double> m_normal;
+        std::exponential_distribution<double> m_exponential;
+
+        inline weight_t clamp(double x) const {
+            if (x <= static_cast<double>(m_options.min_weight)) return m_options.min_weight;
+            if (x >= static_cast<double>(m_options.max_weight)) return m_options.max_weight;
+            return static_cast<weight_t>(std::round(x));
+        }
+
+    public:
+        explicit weight_generator(generator_options const &options)
+                : m_options(options),
+                  m_uniform{options.min_weight, options.max_weight},
+                  m_normal{options.min_weight + (options.max_weight - options.min_weight) / 2.0,
+                           std::max(1.0, (options.max_weight - options.min_weight) / 6.0)},
+                  m_exponential{1.0 / std::max(1.0, (options.max_weight - options.min_weight) / 8.0)} {}
+
+        template<typename Rng>
+        weight_t operator()(Rng &rng) {
+            switch (m_options.distribution) {
+                case weight_distribution::normal:
+                    return clamp(m_normal(rng));
+                case weight_distribution::exponential:
+                    return clamp(m_options.min_weight + m_exponential(rng));
+                case weight_distribution::uniform:
+                    break;
+            }
+
+            return m_uniform(rng);
+        }
+    };
+
+    /**
+     * Edges of a random graph, bucketed by their smaller endpoint: bucket b holds the vertices v
+     * with v * bucket_count / n == b
+     */
+    class random_edges {
+        generator_options m_options;
+        std::size_t m_vertex_count;
+        std::size_t m_edge_count;
+        std::vector<std::vector<generated_edge>> m_buckets;
+        std::vector<key_set> m_keys;
+
+        inline std::size_t bucket_of(std::uint64_t key) const {
+            return static_cast<std::size_t>((key >> 32) * m_buckets.size() / m_vertex_count);
+        }
+
+        /**
+         * Runs the blocks of one round in waves. Every block draws its edges into buckets of its own,
+         * which are then merged into the shared buckets in block order, so the result does not depend
+         * on how the blocks are scheduled.
+         * @param blocks Number of blocks of the round
+         * @param draw Callable taking (block index, scatter) which calls scatter(generated_edge) for every edge
+         * @return Number of edges accepted
+         */
+        template<typename Draw>
+        std::size_t run_round(std::size_t blocks, Draw const &draw, thread_pool *pool) {
+            auto wave = pool == nullptr ? std::size_t{1} : 4 * std::max<std::size_t>(1, pool->size());
+            std::size_t accepted = 0;
+
+            for (std::size_t first = 0; first < blocks; first += wave) {
+                auto count = std::min(wave, blocks - first);
+                std::vector<std::vector<std::vector<generated_edge>>> drawn(count);
+
+                for_each_task(pool, count, [&](std::size_t i) {
+                    auto &own = drawn[i];
+                    own.resize(m_buckets.size());
+
+                    draw(first + i, [this, &own](generated_edge const &e) { own[bucket_of(e.key)].push_back(e); });
+                });
+
+                std::vector<std::size_t> bucket_accepted(m_buckets.size(), 0);
+
+                for_each_task(pool, m_buckets.size(), [&](std::size_t b) {
+                    for (auto &own : drawn) {
+                        for (auto const &e : own[b]) {
+                            if (!m_keys[b].insert(e.key)) continue;
+
+                            m_buckets[b].push_back(e);
+                            ++bucket_accepted[b];
+                        }
+
+                        std::vector<generated_edge>().swap(own[b]);
+                    }
+                });
+
+                for (auto a : bucket_accepted) accepted += a;
+            }
+
+            return accepted;
+        }
+
+        /**
+         * Draws uniformly random pairs which are not in the buckets yet until there are count more edges.
+         *
+         * A drawn pair is new with the probability p that it is neither a loop nor one of the pairs taken already,
+         * so every round draws the missing number of edges divided by p. The round which overshoots the count
+         * gives back a random subset of its new edges, see trim().
+         * @param count Number of edges to add
+         * @param max_edges Number of vertex pairs
+         */
+        void draw_edges(std::size_t count, std::size_t max_edges, thread_pool *pool) {
+            auto n = m_vertex_count;
+            auto taken = std::size_t{0};
+            for (auto const &bucket : m_buckets) taken += bucket.size();
+
+            auto target = taken + count;
+            weight_generator prototype{m_options};
+
+            for (std::uint64_t round = 2; taken < target; round++) {
+                auto missing = target - taken;
+                auto new_pairs = static_cast<double>(max_edges - taken) / max_edges * (n - 1) / n;
+                auto draws = std::max(missing, static_cast<std::size_t>(std::ceil(missing / new_pairs)));
+                auto blocks = (draws + generator_block_size - 1) / generator_block_size;
+
+                std::vector<std::size_t> round_start(m_buckets.size());
+                for (std::size_t b = 0; b < m_buckets.size(); b++) round_start[b] = m_buckets[b].size();
+
+                taken += run_round(blocks, [&](std::size_t block, auto const &scatter) {
+                    std::mt19937_64 rng{block_seed(m_options.seed, round, block)};
+                    std::uniform_int_distribution<std::uint64_t> any_vertex{0, n - 1};
+                    auto weight = prototype;
+                    auto end = std::min(draws, (block + 1) * generator_block_size);
+
+                    for (auto i = block * generator_block_size; i < end; i++) {
+                        auto a = any_vertex(rng), b = any_vertex(rng);
+                        auto w = weight(rng);
+
+                        if (a != b) scatter(generated_edge{edge_key(a, b), w});
+                    }
+                }, pool);
+
+                if (taken > target) {
+                    trim(round_start, taken - target, pool);
+                    taken = target;
+                }
+            }
+        }
+
+        /**
+         * Removes a random subset of the edges added by the last round. The new edges of a round are a uniformly
+         * random set of pairs, and so are the ones which remain. Their keys stay in the hash sets, which is fine
+         * because trim() ends the drawing.
+         * @param round_start Sizes of the buckets before the round
+         * @param count Number of edges to remove, at most the number added by the round
+         */
+        void trim(std::vector<std::size_t> const &round_start, std::size_t count, thread_pool *pool) {
+            std::vector<std::size_t> offsets(m_buckets.size() + 1, 0);
+            for (std::size_t b = 0; b < m_buckets.size(); b++)
+                offsets[b + 1] = offsets[b] + m_buckets[b].size() - round_start[b];
+
+            // Floyd's sampling picks count distinct ranks of the new edges
+            std::mt19937_64 rng{block_seed(m_options.seed, trim_round, 0)};
+            std::unordered_set<std::size_t> picked;
+            picked.reserve(count);
+
+            for (auto j = offsets.back() - count; j < offsets.back(); j++) {
+                auto rank = std::uniform_int_distribution<std::size_t>(0, j)(rng);
+                picked.insert(picked.count(rank) == 0 ? rank : j);
+            }
+
+            std::vector<std::size_t> ranks(picked.begin(), picked.end());
+            std::sort(ranks.begin(), ranks.end());
+
+            for_each_task(pool, m_buckets.size(), [&](std::size_t b) {
+                auto first = std::lower_bound(ranks.begin(), ranks.end(), offsets[b]);
+                auto last = std::lower_bound(first, ranks.end(), offsets[b + 1]);
+                if (first == last) return;
+
+                auto &bucket = m_buckets[b];
+                auto kept = round_start[b];
+
+                for (auto i = round_start[b]; i < bucket.size(); i++) {
+                    if (first != last && *first == offsets[b] + i - round_start[b]) {
+                        ++first;
+                        continue;
+                    }
+
+                    bucket[kept++] = bucket[i];
+                }
+
+                bucket.resize(kept);
+            });
+        }
+
+        /**
+         * Replaces the pairs drawn after the spanning tree by all other pairs. Every bucket enumerates the pairs
+         * of its smaller endpoints in key order and keeps the tree edges with their weights, skips the drawn
+         * pairs and gives the rest weights from a generator of the bucket.
+         * @param tree_sizes Number of tree edges at the front of every bucket
+         */
+        void take_complement(std::vector<std::size_t> const &tree_sizes, weight_generator const &prototype,
+                             thread_pool *pool) {
+            auto by_key = [](generated_edge const &x, generated_edge const &y) { return x.key < y.key; };
+
+            for_each_task(pool, m_buckets.size(), [&](std::size_t b) {
+                auto &bucket = m_buckets[b];
+                auto tree_end = bucket.begin() + static_cast<std::ptrdiff_t>(tree_sizes[b]);
+                std::sort(bucket.begin(), tree_end, by_key);
+                std::sort(tree_end, bucket.end(), by_key);
+
+                std::mt19937_64 rng{block_seed(m_options.seed, complement_round, b)};
+                auto weight = prototype;
+
+                auto tree = bucket.begin(), left_out = tree_end;
+                std::vector<generated_edge> edges;
+
+                for (std::uint64_t a = first_vertex(b); a < first_vertex(b + 1); a++) {
+                    for (auto c = a + 1; c < m_vertex_count; c++) {
+                        auto key = a << 32 | c;
+
+                        if (tree != tree_end && tree->key == key) {
+                            edges.push_back(*tree++);
+                        } else if (left_out != bucket.end() && left_out->key == key) {
+                            ++left_out;
+                        } else {
+                            edges.push_back(generated_edge{key, weight(rng)});
+                        }
+                    }
+                }
+
+                bucket.swap(edges);
+            });
+        }
+
+    public:
+        random_edges(generator_options const &options, thread_pool *pool) : m_options(options) {
+            auto n = options.vertex_count;
+            if (n == 0 || n > UINT32_MAX) throw std::invalid_argument("The vertex count must be in [1, 2^32 - 1]!");
+            if (options.min_weight > options.max_weight) throw std::invalid_argument("The weight range is empty!");
+
+            auto max_edges = n % 2 == 0 ? n / 2 * (n - 1) : (n - 1) / 2 * n;
+            m_vertex_count = n;
+            m_edge_count = std::max(n - 1, std::min(options.edge_count, max_edges));
+
+            if (m_edge_count >= csr_graph::no_edge) throw std::invalid_argument("Too many edges!");
+
+            auto bucket_count = std::max<std::size_t>(1, std::min(m_edge_count / generator_bucket_size, n));
+            m_buckets.resize(bucket_count);
+            m_keys.resize(bucket_count);
+
+            weight_generator prototype{m_options};
+
+            // the random order of the spanning tree is the only serial part
+            std::vector<csr_graph::vertex_id> order(n);
+            std::iota(order.begin(), order.end(), csr_graph::vertex_id{0});
+            std::mt19937_64 order_rng{block_seed(options.seed, 0, 0)};
+            std::shuffle(order.begin(), order.end(), order_rng);
+
+            // every vertex of the order is attached to a random vertex before it
+            auto tree_blocks = (n - 1 + generator_block_size - 1) / generator_block_size;
+
+            auto accepted = run_round(tree_blocks, [&](std::size_t block, auto const &scatter) {
+                std::mt19937_64 rng{block_seed(m_options.seed, 1, block)};
+                auto weight = prototype;
+                auto end = std::min(n, 1 + (block + 1) * generator_block_size);
+
+                for (auto i = 1 + block * generator_block_size; i < end; i++) {
+                    auto parent = order[std::uniform_int_distribution<std::size_t>(0, i - 1)(rng)];
+                    scatter(generated_edge{edge_key(order[i], parent), weight(rng)});
+                }
+            }, pool);
+
+            std::vector<csr_graph::vertex_id>().swap(order);
+
+            // a dense graph has fewer pairs to leave out than to take, so the left out pairs are drawn instead
+            auto dense = m_edge_count - (n - 1) > max_edges - m_edge_count;
+
+            if (!dense) {
+                draw_edges(m_edge_count - accepted, max_edges, pool);
+            } else {
+                std::vector<std::size_t> tree_sizes(bucket_count);
+                for (std::size_t b = 0; b < bucket_count; b++) tree_sizes[b] = m_buckets[b].size();
+
+                draw_edges(max_edges - m_edge_count, max_edges, pool);
+                take_complement(tree_sizes, prototype, pool);
+            }
+
+            for_each_task(pool, bucket_count, [this](std::size_t b) {
+                m_keys[b].clear();
+                std::sort(m_buckets[b].begin(), m_buckets[b].end(),
+                          [](generated_edge const &x, generated_edge const &y) { return x.key < y.key; });
+            });
+        }
+
+        inline std::size_t vertex_count() const { return m_vertex_count; }
+        inline std::size_t edge_count() const { return m_edge_count; }
+        inline std::size_t bucket_count() const { return m_buckets.size(); }
+        inline std::vector<generated_edge> const &bucket(std::size_t b) const { return m_buckets[b]; }
+
+        /**
+         * @return First vertex of a bucket, the bucket ends where the next one starts
+         */
+        inline std::size_t first_vertex(std::size_t b) const {
+            return (b * m_vertex_count + m_buckets.size() - 1) / m_buckets.size();
+        }
+    };
+
+    inline void append_number(std::string &out, std::uint64_t value) {
+        char digits[20];
+        int length = 0;
+
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        while (length > 0) out.push_back(digits[--length]);
+    }
+
+    /**
+     * Edge list being generated, ids are dense from the start
+     */
+    struct edge_list {
+        std::vector<csr_graph::vertex_id> sources;
+        std::vector<csr_graph::vertex_id> targets;
+        std::vector<weight_t> weights;
+        std::unordered_set<std::uint64_t> keys;
+
+        /**
+         * Adds the edge unless it is a loop or it is already there
+         * @return True if the edge was added
+         */
+        bool add(csr_graph::vertex_id a, csr_graph::vertex_id b, weight_t weight) {
+            if (a == b) return false;
+            if (a > b) std::swap(a, b);
+            if (!keys.insert(static_cast<std::uint64_t>(a) << 32 | b).second) return false;
+
+            sources.push_back(a);
+            targets.push_back(b);
+            weights.push_back(weight);
+            return true;
+        }
+
+        csr_graph build(std::size_t vertex_count) {
+            std::vector<vertex> labels(vertex_count);
+            std::iota(labels.begin(), labels.end(), vertex{0});
+
+            return csr_graph(std::move(labels), std::move(sources), std::move(targets), std::move(weights));
+        }
+    };
+
+    typedef std::mt19937_64 random_engine;
+
+    csr_graph generate_grid(std::size_t m, std::uniform_int_distribution<weight_t> &weight, random_engine &rng) {
+        auto side = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(m / 2.0)));
+
+        edge_list edges;
+
+        for (std::size_t row = 0; row < side; row++) {
+            for (std::size_t column = 0; column < side; column++) {
+                auto v = static_cast<csr_graph::vertex_id>(row * side + column);
+
+                if (column + 1 < side) edges.add(v, v + 1, weight(rng));
+                if (row + 1 < side) edges.add(v, static_cast<csr_graph::vertex_id>(v + side), weight(rng));
+            }
+        }
+
+        return edges.build(side * side);
+    }
+
+    csr_graph generate_power_law(std::size_t m, std::size_t degree, std::uniform_int_distribution<weight_t> &weight,
+                                 random_engine &rng) {
+        auto k = std::max<std::size_t>(1, degree / 2);
+        auto n = std::max(k + 1, m / k);
+
+        edge_list edges;
+        edges.keys.reserve(n * k);
+
+        // every endpoint of every edge, so picking a uniform element picks a vertex proportionally to its degree
+        std::vector<csr_graph::vertex_id> endpoints;
+        endpoints.reserve(2 * n * k);
+
+        for (csr_graph::vertex_id a = 0; a <= k; a++) {
+            for (auto b = a + 1; b <= k; b++) {
+                edges.add(a, b, weight(rng));
+                endpoints.push_back(a);
+                endpoints.push_back(b);
+            }
+        }
+
+        if (endpoints.empty()) endpoints.push_back(0);
+
+        for (auto v = static_cast<csr_graph::vertex_id>(k + 1); v < n; v++) {
+            auto end = endpoints.size();
+
+            for (std::size_t attached = 0; attached < k;) {
+                auto target = endpoints[std::uniform_int_distribution<std::size_t>(0, end - 1)(rng)];
+
+                if (edges.add(v, target, weight(rng))) {
+                    endpoints.push_back(v);
+                    endpoints.push_back(target);
+                    attached++;
+                }
+            }
+        }
+
+        return edges.build(n);
+    }
+
+    csr_graph generate_complete(std::size_t m, std::uniform_int_distribution<weight_t> &weight, random_engine &rng) {
+        auto n = std::max<std::size_t>(2, static_cast<std::size_t>((1 + std::sqrt(1 + 8.0 * m)) / 2));
+
+        edge_list edges;
+
+        for (csr_graph::vertex_id a = 0; a < n; a++)
+            for (auto b = a + 1; b < n; b++) edges.add(a, b, weight(rng));
+
+        return edges.build(n);
+    }
+}
+
+bool parse_weight_distribution(std::string const &name, weight_distribution &distribution) {
+    if (name == "uniform") distribution = weight_distribution::uniform;
+    else if (name == "normal") distribution = weight_distribution::normal;
+    else if (name == "exponential") distribution = weight_distribution::exponential;
+    else return false;
+
+    return true;
+}
+
+csr_graph generate_random_graph(generator_options const &options, thread_pool *pool) {
+    random_edges edges{options, pool};
+
+    auto m = edges.edge_count();
+
+    std::vector<std::size_t> bucket_offsets(edges.bucket_count() + 1, 0);
+    for (std::size_t b = 0; b < edges.bucket_count(); b++)
+        bucket_offsets[b + 1] = bucket_offsets[b] + edges.bucket(b).size();
+
+    std::vector<vertex> labels(edges.vertex_count());
+    std::iota(labels.begin(), labels.end(), vertex{0});
+
+    std::vector<csr_graph::vertex_id> sources(m), targets(m);
+    std::vector<weight_t> weights(m);
+
+    for_each_task(pool, edges.bucket_count(), [&](std::size_t b) {
+        auto position = bucket_offsets[b];
+
+        for (auto const &e : edges.bucket(b)) {
+            sources[position] = static_cast<csr_graph::vertex_id>(e.key >> 32);
+            targets[position] = static_cast<csr_graph::vertex_id>(e.key & UINT32_MAX);
+            weights[position] = e.weight;
+            ++position;
+        }
+    });
+
+    return csr_graph(std::move(labels), std::move(sources), std::move(targets), std::move(weights));
+}
+
+void write_random_graph(generator_options const &options, std::string const &filename, bool binary,
+                        thread_pool *pool) {
+    if (binary) {
+        save_binary_graph(generate_random_graph(options, pool), filename);
+        return;
+    }
+
+    random_edges edges{options, pool};
+
+    std::vector<char> buffer(1 << 20);
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(filename, std::ios::out | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open " + filename + " for writing");
+
+    file << edges.vertex_count() << ' ' << edges.edge_count() << '\n';
+
+    // formats a few buckets in parallel and writes them in order, so only those are held as text
+    auto wave = pool == nullptr ? std::size_t{1} : 2 * std::max<std::size_t>(1, pool->size());
+
+    for (std::size_t first = 0; first < edges.bucket_count(); first += wave) {
+        auto count = std::min(wave, edges.bucket_count() - first);
+        std::vector<std::string> texts(count);
+
+        for_each_task(pool, count, [&](std::size_t i) {
+            auto b = first + i;
+            auto const &bucket = edges.bucket(b);
+            auto &text = texts[i];
+            text.reserve(bucket.size() * 16);
+
+            auto e = bucket.begin();
+
+            for (auto v = edges.first_vertex(b); v < edges.first_vertex(b + 1); v++) {
+                auto end = e;
+                while (end != bucket.end() && (end->key >> 32) == v) ++end;
+
+                append_number(text, v);
+                text.push_back(' ');
+                append_number(text, static_cast<std::uint64_t>(end - e));
+
+                for (; e != end; ++e) {
+                    text.push_back(' ');
+                    append_number(text, e->key & UINT32_MAX);
+                    text.push_back(' ');
+                    append_number(text, e->weight);
+                }
+
+                text.push_back('\n');
+            }
+        });
+
+        for (auto const &text : texts) file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    if (!file.flush()) throw std::runtime_error("Cannot write " + filename);
+}
+
+bool parse_graph_family(std::string const &name, graph_family &family) {
+    if (name == "random") family = graph_family::random;
+    else if (name == "grid") family = graph_family::grid;
+    else if (name == "power-law") family = graph_family::power_law;
+    else if (name == "complete") family = graph_family::complete;
+    else return false;
+
+    return true;
+}
+
+std::string to_string(graph_family family) {
+    switch (family) {
+        case graph_family::random:
+            return "random";
+        case graph_family::grid:
+            return "grid";
+        case graph_family::power_law:
+            return "power-law";
+        case graph_family::complete:
+            return "complete";
+    }
+
+    return "unknown";
+}
+
+csr_graph generate_graph(graph_family family, std::size_t edge_count, std::size_t average_degree,
+                         weight_t max_weight, std::uint64_t seed) {
+    random_engine rng{seed};
+    std::uniform_int_distribution<weight_t> weight{1, std::max<weight_t>(1, max_weight)};
+
+    generator_options options{};
+    options.vertex_count = std::max<std::size_t>(2, 2 * edge_count / std::max<std::size_t>(1, average_degree));
+    options.edge_count = edge_count;
+    options.max_weight = std::max<weight_t>(1, max_weight);
+    options.seed = seed;
+
+    switch (family) {
+        case graph_family::random:
+            return generate_random_graph(options, nullptr);
+        case graph_family::grid:
+            return generate_grid(edge_count, weight, rng);
+        case graph_family::power_law:
+            return generate_power_law(edge_count, average_degree, weight, rng);
+        case graph_family::complete:
+            return generate_complete(edge_count, weight, rng);
+    }
+
+    return generate_random_graph(options, nullptr);
+}
@@ -0,0 +1,102 @@
+#ifndef MINIMUM_SPANNING_TREE_GRAPH_GENERATOR_H
+#define MINIMUM_SPANNING_TREE_GRAPH_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "csr_graph.h"
+
+class thread_pool;
+
+/**
+ * Distributions of the generated weights, all of them are clamped to [min_weight, max_weight]
+ */
+enum class weight_distribution {
+    uniform,        // every weight equally likely
+    normal,         // centered in the range with a standard deviation of 1/6 of it
+    exponential     // mean at 1/8 of the range above min_weight, so most edges are light
+};
+
+/**
+ * @param name Distribution name: uniform, normal or exponential
+ * @param distribution Receives the distribution
+ * @return False if the name is unknown
+ */
+bool parse_weight_distribution(std::string const &name, weight_distribution &distribution);
+
+/**
+ * Parameters of a random connected graph
+ */
+struct generator_options {
+    std::size_t vertex_count;
+    std::size_t edge_count;
+    weight_t min_weight{1};
+    weight_t max_weight{100};
+    weight_distribution distribution{weight_distribution::uniform};
+    std::uint64_t seed{42};
+};
+
+/**
+ * Generates a random connected graph without loops and parallel edges.
+ *
+ * A random spanning tree comes first: the vertices are shuffled and each one is attached to a random vertex
+ * before it. The remaining edges are drawn uniformly in blocks of a fixed size, each block with its own
+ * generator seeded from the seed and the block index, so the graph depends only on the options and not on
+ * the thread count. The blocks scatter their edges into buckets by the smaller endpoint, and every bucket
+ * drops duplicates with its own hash set. Every round draws enough pairs to make up for the expected duplicates,
+ * and the round which overshoots the count drops a random subset of its new edges. When more pairs would be
+ * taken than left out, the pairs to leave out are drawn instead and every bucket lists all other pairs.
+ * @param options Vertex and edge counts, weights and seed. The edge count is clamped to [n - 1, n (n - 1) / 2].
+ * @param pool Pool generating the blocks and filling the buckets, nullptr runs in the calling thread
+ * @return The graph with vertices labeled 0..n-1, edges ordered by (smaller endpoint, larger endpoint)
+ * @throws std::invalid_argument if there are no vertices or too many for the CSR representation
+ */
+csr_graph generate_random_graph(generator_options const &options, thread_pool *pool);
+
+/**
+ * Generates a graph like generate_random_graph() and writes it to a file. The text format is written
+ * in a streaming fashion, a few buckets at a time, with each edge listed once on the line of its smaller
+ * endpoint. The binary format needs the whole adjacency, so the graph is built in memory first.
+ * @param options Parameters of the graph
+ * @param filename Path to the file
+ * @param binary Writes the binary format instead of the text one
+ * @param pool Pool generating the graph and formatting the text, nullptr runs in the calling thread
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_random_graph(generator_options const &options, std::string const &filename, bool binary,
+                        thread_pool *pool);
+
+/**
+ * Shapes of the synthetic graphs
+ */
+enum class graph_family {
+    random,     // G(n, m) on top of a random spanning tree, see generate_random_graph()
+    grid,       // square grid, every vertex connected to its right and lower neighbor (road-like)
+    power_law,  // Barabási-Albert preferential attachment, a few hubs with a very high degree
+    complete    // every pair of vertices connected
+};
+
+/**
+ * @param name Family name: random, grid, power-law or complete
+ * @param family Receives the family
+ * @return False if the name is unknown
+ */
+bool parse_graph_family(std::string const &name, graph_family &family);
+
+std::string to_string(graph_family family);
+
+/**
+ * Generates a connected graph of a family with uniformly distributed weights. The same arguments always
+ * give the same graph. The vertex count is derived from the edge count, which is met only approximately
+ * by the grid and complete families.
+ * @param family Shape of the graph
+ * @param edge_count Number of edges
+ * @param average_degree Average vertex degree of the random and power-law families
+ * @param max_weight Weights are drawn from [1, max_weight]
+ * @param seed Seed of the random number generator
+ * @return The graph with vertices labeled 0..n-1
+ */
+csr_graph generate_graph(graph_family family, std::size_t edge_count, std::size_t average_degree,
+                         weight_t max_weight, std::uint64_t seed);
+
+#endif //MINIMUM_SPANNING_TREE_GRAPH_GENERATOR_H
@@ -0,0 +1,93 @@
+#include "mst_engine.h"
+#include <algorithm>
+#include "radix_sort.h"
+#include "union_find.h"
+
+namespace {
+    /**
+     * Ranges this short are sorted right away instead of being partitioned further
+     */
+    const std::size_t filter_kruskal_threshold = 1024;
+
+    /**
+     * Adds the edges of a range sorted by csr_graph::lighter() to the tree unless they close a cycle
+     * @return False once the tree spans the whole graph, so the caller can stop early
+     */
+    bool add_sorted_edges(csr_graph const &g, csr_graph::edge_id const *begin, csr_graph::edge_id const *end,
+                          arena_union_find &sets, edge_ids_t &tree) {
+        auto sources = g.sources();
+        auto targets = g.targets();
+
+        for (auto it = begin; it != end && sets.set_count() > 1; ++it)
+            if (sets.unite(sources[*it], targets[*it])) tree.push_back(*it);
+
+        return sets.set_count() > 1;
+    }
+
+    void sort_edges(csr_graph const &g, csr_graph::edge_id *begin, csr_graph::edge_id *end) {
+        std::sort(begin, end, [&g](csr_graph::edge_id a, csr_graph::edge_id b) { return g.lighter(a, b); });
+    }
+
+    /**
+     * Processes [begin, end) in the order of csr_graph::lighter(). The range is partitioned around the median
+     * of three edges, the lighter part is processed first and edges of the heavier part which are already
+     * inside a component are removed before it is processed.
+     * @return False once the tree spans the whole graph
+     */
+    bool filter_kruskal(csr_graph const &g, csr_graph::edge_id *begin, csr_graph::edge_id *end,
+                        arena_union_find &sets, edge_ids_t &tree) {
+        auto sources = g.sources();
+        auto targets = g.targets();
+
+        while (static_cast<std::size_t>(end - begin) > filter_kruskal_threshold) {
+            auto lighter = [&g](csr_graph::edge_id a, csr_graph::edge_id b) { return g.lighter(a, b); };
+
+            csr_graph::edge_id candidates[] = {*begin, begin[(end - begin) / 2], *(end - 1)};
+            std::sort(candidates, candidates + 3, lighter);
+            auto pivot = candidates[1];
+
+            auto middle = std::partition(begin, end, [&](csr_graph::edge_id e) { return !g.lighter(pivot, e); });
+
+            if (!filter_kruskal(g, begin, middle, sets, tree)) return false;
+
+            // the heavy part is filtered in place and processed by the next iteration
+            end = std::remove_if(middle, end, [&](csr_graph::edge_id e) {
+                return sets.find(sources[e]) == sets.find(targets[e]);
+            });
+            begin = middle;
+        }
+
+        sort_edges(g, begin, end);
+        return add_sorted_edges(g, begin, end, sets, tree);
+    }
+
+    arena_vector<csr_graph::edge_id> all_edges(csr_graph const &g, arena &scratch) {
+        arena_vector<csr_graph::edge_id> edges(g.edge_count(), arena_allocator<csr_graph::edge_id>(scratch));
+        for (std::size_t e = 0; e < edges.size(); e++) edges[e] = static_cast<csr_graph::edge_id>(e);
+        return edges;
+    }
+}
+
+edge_ids_t kruskal_mst::run(csr_graph const &g, thread_pool *pool, arena &scratch) const {
+    auto edges = sorted_edges(g, pool, scratch);
+
+    arena_union_find sets{g.vertex_count(), arena_allocator<union_find::id_t>(scratch)};
+    edge_ids_t tree;
+    tree.reserve(g.vertex_count());
+
+    add_sorted_edges(g, edges.data(), edges.data() + edges.size(), sets, tree);
+
+    return tree;
+}
+
+edge_ids_t filter_kruskal_mst::run(csr_graph const &g, thread_pool *, arena &scratch) const {
+    auto edges = all_edges(g, scratch);
+
+    arena_union_find sets{g.vertex_count(), arena_allocator<union_find::id_t>(scratch)};
+    edge_ids_t tree;
+    tree.reserve(g.vertex_count());
+
+    filter_kruskal(g, edges.data(), edges.data() + edges.size(), sets, tree);
+
+    return tree;
+}
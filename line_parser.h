@@ -0,0 +1,60 @@
+#ifndef MINIMUM_SPANNING_TREE_LINE_PARSER_H
+#define MINIMUM_SPANNING_TREE_LINE_PARSER_H
+
+#include <cstdint>
+
+/**
+ * Reads unsigned decimal numbers separated by blanks from one line, without locales or streams
+ */
+class line_parser {
+    char const *m_current;
+    char const *m_end;
+
+    inline void skip_blanks() {
+        while (m_current != m_end && (*m_current == ' ' || *m_current == '\t' || *m_current == '\r')) ++m_current;
+    }
+
+public:
+    line_parser(char const *begin, char const *end) : m_current{begin}, m_end{end} {}
+
+    inline bool at_end() {
+        skip_blanks();
+        return m_current == m_end;
+    }
+
+    /**
+     * Consumes a character if it is the next token
+     * @param c The character
+     * @return True if it was there
+     */
+    inline bool skip(char c) {
+        skip_blanks();
+        if (m_current == m_end || *m_current != c) return false;
+
+        ++m_current;
+        return true;
+    }
+
+    /**
+     * @param value Receives the number
+     * @return False if the next token is not a number or it does not fit into 64 bits
+     */
+    inline bool read(std::uint64_t &value) {
+        skip_blanks();
+        if (m_current == m_end || *m_current < '0' || *m_current > '9') return false;
+
+        value = 0;
+        while (m_current != m_end && *m_current >= '0' && *m_current <= '9') {
+            auto digit = static_cast<std::uint64_t>(*m_current - '0');
+            if (value > (UINT64_MAX - digit) / 10) return false;
+
+            value = value * 10 + digit;
+            ++m_current;
+        }
+
+        // a number glued to anything else than a blank is a malformed token
+        return m_current == m_end || *m_current == ' ' || *m_current == '\t' || *m_current == '\r';
+    }
+};
+
+#endif //MINIMUM_SPANNING_TREE_LINE_PARSER_H
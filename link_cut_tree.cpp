@@ -0,0 +1,165 @@
+#include "link_cut_tree.h"
+#include <utility>
+
+const link_cut_tree::node_id link_cut_tree::nil;
+
+link_cut_tree::node_id link_cut_tree::add_node(weight_t weight, bool weighted) {
+    node_id x;
+
+    if (m_free.empty()) {
+        x = static_cast<node_id>(m_nodes.size());
+        m_nodes.emplace_back();
+    } else {
+        x = m_free.back();
+        m_free.pop_back();
+    }
+
+    m_nodes[x] = node{{nil, nil}, nil, x, weight, weighted, false};
+    return x;
+}
+
+void link_cut_tree::remove_node(node_id x) {
+    m_free.push_back(x);
+}
+
+bool link_cut_tree::is_splay_root(node_id x) const {
+    auto p = m_nodes[x].parent;
+    return p == nil || (m_nodes[p].child[0] != x && m_nodes[p].child[1] != x);
+}
+
+bool link_cut_tree::heavier(node_id a, node_id b) const {
+    auto const &x = m_nodes[a], &y = m_nodes[b];
+
+    if (x.weighted != y.weighted) return x.weighted;
+    if (!x.weighted) return a > b;
+    if (x.weight != y.weight) return x.weight > y.weight;
+
+    return a > b;
+}
+
+void link_cut_tree::push(node_id x) {
+    auto &n = m_nodes[x];
+    if (!n.reversed) return;
+
+    std::swap(n.child[0], n.child[1]);
+    for (auto c : n.child)
+        if (c != nil) m_nodes[c].reversed = !m_nodes[c].reversed;
+
+    n.reversed = false;
+}
+
+void link_cut_tree::update(node_id x) {
+    auto &n = m_nodes[x];
+    n.heaviest = x;
+
+    for (auto c : n.child)
+        if (c != nil && heavier(m_nodes[c].heaviest, n.heaviest)) n.heaviest = m_nodes[c].heaviest;
+}
+
+void link_cut_tree::rotate(node_id x) {
+    auto p = m_nodes[x].parent;
+    auto g = m_nodes[p].parent;
+    auto side = m_nodes[p].child[1] == x ? 1 : 0;
+
+    // the grandparent keeps pointing to the parent's splay tree only if the parent is its child in the splay tree
+    if (!is_splay_root(p)) m_nodes[g].child[m_nodes[g].child[1] == p ? 1 : 0] = x;
+    m_nodes[x].parent = g;
+
+    auto moved = m_nodes[x].child[1 - side];
+    m_nodes[p].child[side] = moved;
+    if (moved != nil) m_nodes[moved].parent = p;
+
+    m_nodes[x].child[1 - side] = p;
+    m_nodes[p].parent = x;
+
+    update(p);
+    update(x);
+}
+
+void link_cut_tree::splay(node_id x) {
+    // pending reversals have to be pushed from the top of the splay tree down to x before rotating
+    std::vector<node_id> path{x};
+    for (auto y = x; !is_splay_root(y); y = m_nodes[y].parent) path.push_back(m_nodes[y].parent);
+    for (auto it = path.rbegin(); it != path.rend(); ++it) push(*it);
+
+    while (!is_splay_root(x)) {
+        auto p = m_nodes[x].parent;
+
+        if (!is_splay_root(p)) {
+            auto g = m_nodes[p].parent;
+            auto zig_zig = (m_nodes[g].child[0] == p) == (m_nodes[p].child[0] == x);
+            rotate(zig_zig ? p : x);
+        }
+
+        rotate(x);
+    }
+}
+
+void link_cut_tree::access(node_id x) {
+    node_id last = nil;
+
+    for (auto y = x; y != nil; y = m_nodes[y].parent) {
+        splay(y);
+        m_nodes[y].child[1] = last;
+        update(y);
+        last = y;
+    }
+
+    splay(x);
+}
+
+void link_cut_tree::make_root(node_id x) {
+    access(x);
+    m_nodes[x].reversed = !m_nodes[x].reversed;
+    push(x);
+}
+
+void link_cut_tree::set_weight(node_id x, weight_t weight) {
+    // after access x is the root of the only splay tree whose aggregates include it
+    access(x);
+    m_nodes[x].weight = weight;
+    update(x);
+}
+
+link_cut_tree::node_id link_cut_tree::find_root(node_id x) {
+    access(x);
+
+    while (true) {
+        push(x);
+        if (m_nodes[x].child[0] == nil) break;
+        x = m_nodes[x].child[0];
+    }
+
+    splay(x);
+    return x;
+}
+
+bool link_cut_tree::connected(node_id x, node_id y) {
+    if (x == y) return true;
+
+    auto root = find_root(x);
+    return find_root(y) == root;
+}
+
+void link_cut_tree::link(node_id x, node_id y) {
+    make_root(x);
+    m_nodes[x].parent = y;
+}
+
+void link_cut_tree::cut(node_id x, node_id y) {
+    make_root(x);
+    access(y);
+
+    // the path x..y is exactly x and y now, x being the left child of y
+    m_nodes[y].child[0] = nil;
+    m_nodes[x].parent = nil;
+    update(y);
+}
+
+link_cut_tree::node_id link_cut_tree::path_max(node_id x, node_id y) {
+    make_root(x);
+    access(y);
+
+    auto heaviest = m_nodes[y].heaviest;
+    return m_nodes[heaviest].weighted ? heaviest : nil;
+}
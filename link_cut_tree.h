@@ -0,0 +1,94 @@
+#ifndef MINIMUM_SPANNING_TREE_LINK_CUT_TREE_H
+#define MINIMUM_SPANNING_TREE_LINK_CUT_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "edge.h"
+
+/**
+ * Link-cut tree (Sleator, Tarjan) over a forest of weighted nodes.
+ *
+ * Every preferred path is kept in a splay tree ordered by depth, with lazy reversal so any node can be made
+ * the root of its tree. Each splay node aggregates the heaviest node of its subtree, which answers path-maximum
+ * queries. All operations take O(log n) amortized time.
+ *
+ * Edges with weights are represented as nodes of their own: an edge between u and v is a node e linked
+ * to both u and v, and plain vertex nodes carry no weight, so the heaviest node on a path is its heaviest edge.
+ */
+class link_cut_tree {
+public:
+    typedef std::uint32_t node_id;
+
+    static const node_id nil = UINT32_MAX;
+
+private:
+    struct node {
+        node_id child[2];
+        node_id parent;
+        node_id heaviest;
+        weight_t weight;
+        bool weighted;
+        bool reversed;
+    };
+
+    std::vector<node> m_nodes{};
+    std::vector<node_id> m_free{};
+
+    bool is_splay_root(node_id x) const;
+    bool heavier(node_id a, node_id b) const;
+    void push(node_id x);
+    void update(node_id x);
+    void rotate(node_id x);
+    void splay(node_id x);
+    void access(node_id x);
+    void make_root(node_id x);
+
+public:
+    /**
+     * Adds an isolated node
+     * @param weight Weight of the node, used only if weighted is true
+     * @param weighted False for nodes which never are the heaviest on a path (vertices)
+     * @return Id of the node, ids of removed nodes are reused
+     */
+    node_id add_node(weight_t weight, bool weighted);
+
+    /**
+     * Removes an isolated node, its id may be returned by a later add_node()
+     */
+    void remove_node(node_id x);
+
+    inline weight_t weight(node_id x) const { return m_nodes[x].weight; }
+
+    /**
+     * Changes the weight of a node, the node may be linked
+     */
+    void set_weight(node_id x, weight_t weight);
+
+    /**
+     * Finds the root of the tree containing x. The root changes whenever make_root() is called internally,
+     * so only compare the results of two calls made without other operations in between.
+     */
+    node_id find_root(node_id x);
+
+    bool connected(node_id x, node_id y);
+
+    /**
+     * Adds the edge x-y to the forest, x and y must be in different trees
+     */
+    void link(node_id x, node_id y);
+
+    /**
+     * Removes the edge x-y from the forest, the edge must exist
+     */
+    void cut(node_id x, node_id y);
+
+    /**
+     * Finds the heaviest weighted node on the path between x and y, which must be connected.
+     * Ties are broken by the larger id.
+     * @return Id of the heaviest node or nil if no node of the path is weighted
+     */
+    node_id path_max(node_id x, node_id y);
+};
+
+#endif //MINIMUM_SPANNING_TREE_LINK_CUT_TREE_H
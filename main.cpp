@@ -1,32 +1,124 @@
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <random>
+#include <utility>
 #include <fstream>
 #include <iomanip>
 
+#include "batch.h"
+#include "boruvka_trace.h"
+#include "connected_components.h"
+#include "csr_graph.h"
+#include "distributed_boruvka.h"
+#include "dynamic_mst.h"
+#include "external_mst.h"
 #include "graph.h"
+#include "graph_file.h"
+#include "graph_generator.h"
+#include "mst_cache.h"
+#include "mst_engine.h"
+#include "mst_verify.h"
+#include "result_writer.h"
+#include "thread_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <unistd.h>
+
+#endif
+
+/**
+ * Options shared by the commands
+ */
+struct program_options {
+    std::string algorithm{"boruvka"};
+    generator_options generator{0, 0};
+    bool seeded{false};
+    std::string input{"graph_data.txt"};
+    std::string delta{"delta.txt"};
+    std::string updated_graph{};
+    std::string output{"result.txt"};
+    result_format format{result_format::adjacency};
+    bool stream{false};
+    std::string manifest{"-"};
+    std::size_t concurrency{0};
+    std::size_t workers{0};
+    std::string certificate{};
+    std::string cache{};
+    std::uint64_t cache_limit{std::uint64_t{1} << 30};
+    bool verify_checksum{true};
+    bool trace{false};
+    bool forest{false};
+};
 
 template<typename TimePoint>
 std::chrono::milliseconds to_ms(TimePoint tp) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(tp);
 }
 
-unsigned long get_random_number_in_range(unsigned long start, unsigned long end) {
-    static std::mt19937 mt{std::random_device{}()};
-    std::uniform_int_distribution<unsigned long> dist(start, end);
-    return dist(mt);
-}
-
 void print_help() {
     std::cout << "\n\n<Command> may be one of the following:\n" << std::endl
-              << "--generate\t Generate random graph and save to graph_data.txt" << std::endl
-              << "--single\t Run Borůvka's algorithm using single thread using data from graph_data.txt" << std::endl
+              << "--generate\t Generate a random connected graph and save it to graph_data.txt" << std::endl
+              << "\t\t (or to the --input file, in the binary format if its name ends with .bin)" << std::endl
+              << "--single\t Run the MST engine using single thread using data from graph_data.txt" << std::endl
               << "\t\t result will be saved to result.txt" << std::endl
-              << "--parallel\t Run Borůvka's algorithm in multiple threads using data from graph_data.txt" << std::endl
+              << "--parallel\t Run the MST engine in multiple threads using data from graph_data.txt" << std::endl
               << "\t\t result will be saved to result.txt" << std::endl
-              << "--compare\t Compares single and multi-threaded execution and prints the result"
+              << "--compare\t Compares single and multi-threaded execution and prints the result" << std::endl
+              << "--components\t Finds the connected components of graph_data.txt in multiple threads" << std::endl
+              << "--convert\t Converts graph_data.txt to the binary format and saves it to graph_data.bin" << std::endl
+              << "--external\t Computes the MST out of core, streaming the edges from the disk in every pass" << std::endl
+              << "\t\t the MST edges are saved to result.txt as \"<start> <end> <weight>\" lines" << std::endl
+              << "\t\t (--format=edges, the other formats are not supported)" << std::endl
+              << "--distributed\t Runs Borůvka's algorithm in worker processes, each owning a range of the vertices" << std::endl
+              << "--verify\t Checks that result.txt (in any --format) is a minimum spanning tree of graph_data.txt" << std::endl
+              << "--batch\t Solves every graph listed in the manifest, one \"<input> [<output>]\" line per job," << std::endl
+              << "\t\t several jobs at once, and reports the time of every job" << std::endl
+              << "--update\t Applies the changes of delta.txt to graph_data.txt and to its MST in result.txt" << std::endl
+              << "\t\t instead of recomputing it, \"<start> <end> <weight>\" lines insert an edge or set" << std::endl
+              << "\t\t its weight and \"- <start> <end>\" lines delete it; the updated graph is saved to" << std::endl
+              << "\t\t graph_data.updated.txt (see --updated-graph)" << std::endl
+              << "\n<Options> may precede or follow the command:\n" << std::endl
+              << "--threads=<n>\t Number of worker threads used by --parallel (default: hardware concurrency)" << std::endl
+              << "--algorithm=<a>\t MST engine: boruvka (default), contracting-boruvka, kruskal, prim, filter-kruskal or auto" << std::endl
+              << "\t\t auto picks the engine by the density of the graph" << std::endl
+              << "--input=<file>\t Graph file used instead of graph_data.txt, text or binary (see --convert)" << std::endl
+              << "--delta=<file>\t Changes applied by --update instead of delta.txt" << std::endl
+              << "--updated-graph=<file> File --update saves the updated graph to (default: the input file with" << std::endl
+              << "\t\t .updated before the extension, graph_data.updated.txt)" << std::endl
+              << "--output=<file>\t File the MST is saved to instead of result.txt" << std::endl
+              << "--format=<f>\t Format of the saved MST: adjacency (default, the format of graph_data.txt)," << std::endl
+              << "\t\t edges (\"<start> <end> <weight>\" lines sorted by the endpoints) or binary" << std::endl
+              << "--manifest=<file> Job list of --batch, - reads the jobs from the standard input (default)" << std::endl
+              << "--concurrency=<n> Jobs solved at once by --batch (default: the thread count)" << std::endl
+              << "--workers=<n>\t Worker processes of --distributed (default: hardware concurrency)" << std::endl
+              << "--cache=<dir>\t Keeps the MSTs of --single, --parallel and --batch in the directory and reuses them" << std::endl
+              << "\t\t for graphs with the same vertices and edges instead of computing them again" << std::endl
+              << "--cache-limit=<n> Size limit of the --cache directory in MiB, the least recently used" << std::endl
+              << "\t\t MSTs are deleted (default: 1024)" << std::endl
+              << "--certificate=<file> Makes --verify save the heaviest tree edge on the cycle of every non-tree edge" << std::endl
+              << "--stream\t Writes the MST edges while the engine runs, as soon as they are committed" << std::endl
+              << "\t\t (unsorted, needs --format=edges or --format=binary)" << std::endl
+              << "--vertices=<n>\t Vertex count of --generate (default: random in [300, 500])" << std::endl
+              << "--edges=<n>\t Edge count of --generate (default: random in [4000, 6000])" << std::endl
+              << "--min-weight=<n> Lightest weight of --generate (default: 1)" << std::endl
+              << "--max-weight=<n> Heaviest weight of --generate (default: 100)" << std::endl
+              << "--distribution=<d> Weight distribution of --generate: uniform (default), normal or exponential"
+              << std::endl
+              << "--seed=<n>\t Seed of --generate, the same seed gives the same graph (default: random)" << std::endl
+              << "--trace\t\t Records every round of the boruvka engine, prints a summary table and saves" << std::endl
+              << "\t\t a Chrome trace (chrome://tracing or ui.perfetto.dev) to trace.json" << std::endl
+              << "--forest\t Computes a minimum spanning forest (an MST per component) of a disconnected graph" << std::endl
+              << "\t\t instead of failing" << std::endl
+              << "--no-checksum\t Skips the checksum verification when loading a binary graph"
               << "\n\nMade by antosand" << std::endl;
 }
 
+void print_sum_of_edge_weights(unsigned long long sum) {
+    std::cout << "The sum of edge weights is " << sum << "." << std::endl;
+}
+
 void print_sum_of_edge_weights(graph const &g) {
     unsigned long sum = 0;
 
@@ -34,10 +126,16 @@ void print_sum_of_edge_weights(graph const &g) {
         sum += edge.weight;
     }
 
-    std::cout << "The sum of edge weights is " << sum << "." << std::endl;
+    print_sum_of_edge_weights(sum);
 }
 
 void print_comparison(std::chrono::milliseconds single_thread_ms, std::chrono::milliseconds multi_thread_ms) {
+    // a failed run takes no time, and a millisecond is too coarse to compare runs on tiny graphs
+    if (single_thread_ms.count() <= 0 || multi_thread_ms.count() <= 0) {
+        std::cout << "\nThe runs took less than a millisecond or failed, they cannot be compared." << std::endl;
+        return;
+    }
+
     std::cout << std::setprecision(2);
 
     if (multi_thread_ms < single_thread_ms) {
@@ -49,41 +147,52 @@ void print_comparison(std::chrono::milliseconds single_thread_ms, std::chrono::m
     }
 }
 
-graph generate_random_graph(unsigned long vertex_count = get_random_number_in_range(300, 500),
-                            unsigned long edge_count = get_random_number_in_range(4000, 6000)) {
-
-    std::cout << "Generating a random graph..." << std::endl;
-    std::cout << "Generated graph has " << vertex_count << " vertices." << std::endl;
+/**
+ * Generates a random connected graph and saves it to the input file
+ * @param options Program options with the generator parameters
+ */
+void generate(program_options options) {
+    std::mt19937_64 random{std::random_device{}()};
+    auto &generator = options.generator;
 
-    graph g{};
+    if (generator.vertex_count == 0) generator.vertex_count = std::uniform_int_distribution<std::size_t>(300, 500)(random);
+    if (generator.edge_count == 0) generator.edge_count = std::uniform_int_distribution<std::size_t>(4000, 6000)(random);
+    if (!options.seeded) generator.seed = random();
 
-    for (unsigned long i = 0; i < vertex_count; i++)
-        g.add_vertex(i);
+    auto suffix = std::string(".bin");
+    auto binary = options.input.size() > suffix.size() &&
+                  options.input.compare(options.input.size() - suffix.size(), suffix.size(), suffix) == 0;
 
-    std::cout << "Generated graph has " << edge_count << " edges." << std::endl;
+    std::cout << "Generating a random graph with " << generator.vertex_count << " vertices and "
+              << generator.edge_count << " edges (seed " << generator.seed << ")." << std::endl;
 
-    for (unsigned long i = 0; i < edge_count; i++) {
-        while (true) {
-            auto edge_start{g.get_vertex_at(get_random_number_in_range(0, vertex_count - 1))};
-            auto edge_end{g.get_vertex_at(get_random_number_in_range(0, vertex_count - 1))};
-
-            auto e = edge(edge_start, edge_end, get_random_number_in_range(1, 100));
+    try {
+        auto start = std::chrono::high_resolution_clock::now();
+        write_random_graph(generator, options.input, binary, &thread_pool::global());
+        auto end = std::chrono::high_resolution_clock::now();
 
-            if (!g.has_edge(e)) {
-                g.add_edge(e);
-                break;
-            }
-        }
+        std::cout << "Random graph was generated in " << to_ms(end - start).count() << " ms and saved to "
+                  << options.input << "." << std::endl;
+    } catch (std::invalid_argument const &error) {
+        std::cout << error.what() << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
     }
+}
 
-    std::cout << "Checking if the generated graph is connected..." << std::endl;
-    if (g.is_connected()) {
-        std::cout << "Random graph was generated!" << std::endl << std::endl;
-        return g;
-    } else {
-        std::cout << "Randomly generated graph is not connected :c\nGenerating new graph." << std::endl;
-        return generate_random_graph(vertex_count, edge_count);
-    }
+/**
+ * Checks if an argument has the form --name=value and extracts the value
+ * @param arg Program argument
+ * @param name Option name including the leading dashes
+ * @param value Receives the value
+ * @return True if the argument is the option
+ */
+bool read_option(std::string const &arg, std::string const &name, std::string &value) {
+    if (arg.size() <= name.size() || arg.compare(0, name.size(), name) != 0 || arg[name.size()] != '=')
+        return false;
+
+    value = arg.substr(name.size() + 1);
+    return true;
 }
 
 bool fexists(std::string const &filename) {
@@ -91,146 +200,799 @@ bool fexists(std::string const &filename) {
     return (bool)ifile;
 }
 
-graph const load_from_file(std::string const &filename) {
-
+/**
+ * Loads a graph in the text format using the global thread pool
+ * @param filename Path to the file
+ * @return CSR graph
+ * @throws parse_error if the file is malformed
+ */
+csr_graph load_from_file(std::string const &filename) {
     if (!fexists(filename)) {
         std::cout << "Looks like file with the data doesn't exist!\nYou should run --generate first!" << std::endl;
-        throw;
+        throw std::runtime_error("Cannot open " + filename);
     }
 
     std::cout << "Loading graph from " << filename << "." << std::endl;
 
-    std::ifstream file;
+    auto g = load_text_graph(filename, &thread_pool::global());
+
+    std::cout << "Finished loading graph from file." << std::endl;
 
-    file.open(filename, std::ios::in);
+    return g;
+}
 
-    int vertex_count, edge_count;
-    file >> vertex_count >> edge_count;
+/**
+ * Loads a graph in the text or in the binary format, which is recognized by the magic at the start of the file.
+ * Binary files are memory-mapped and used without parsing.
+ * @param options Program options with the input path
+ * @return CSR graph
+ */
+csr_graph load_graph(program_options const &options) {
+    if (!fexists(options.input) || !is_binary_graph_file(options.input))
+        return load_from_file(options.input);
 
-    graph g{};
+    std::cout << "Loading binary graph from " << options.input << "." << std::endl;
 
-    for (int i = 0; i < vertex_count; i++) g.add_vertex(i); // we already know what vertices are in a graph
-    for (int i = 0; i < vertex_count; i++) {
-        int start, vertex_edge_count; // start is basically the same as i
-        file >> start >> vertex_edge_count;
+    auto g = load_binary_graph(options.input, options.verify_checksum);
 
-        for (int j = 0; j < vertex_edge_count; j++) {
-            int destination;
-            unsigned long weight;
-            file >> destination >> weight; // read edge
+    std::cout << "Finished loading graph from file." << std::endl;
 
-            if (!g.has_edge(edge(start, destination, weight))) g.add_edge(edge(start, destination, weight));
-        }
+    return g;
+}
+
+/**
+ * Derives the name of the binary file from the name of the text file, graph_data.txt becomes graph_data.bin
+ * @param filename Name of the text file
+ * @return Name of the binary file
+ */
+std::string binary_filename(std::string const &filename) {
+    auto suffix = std::string(".txt");
+
+    if (filename.size() > suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0)
+        return filename.substr(0, filename.size() - suffix.size()) + ".bin";
+
+    return filename + ".bin";
+}
+
+/**
+ * Converts the text input file to the binary format
+ * @param options Program options with the input path
+ */
+void convert(program_options const &options) {
+    auto output = binary_filename(options.input);
+
+    try {
+        auto g = load_from_file(options.input);
+
+        std::cout << "Saving the binary graph to " << output << "." << std::endl;
+
+        save_binary_graph(g, output);
+        std::cout << "Graph is saved to " << output << "." << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
     }
+}
 
-    file.close();
+/**
+ * Derives the name of the updated graph from the name of the input file, graph_data.txt becomes
+ * graph_data.updated.txt
+ * @param filename Name of the input file
+ * @return Name of the updated file
+ */
+std::string updated_filename(std::string const &filename) {
+    auto dot = filename.find_last_of('.');
+    auto slash = filename.find_last_of('/');
 
-    std::cout << "Finished loading graph from file." << std::endl;
+    if (dot == std::string::npos || dot == 0 || (slash != std::string::npos && dot < slash + 2))
+        return filename + ".updated";
 
-    return g;
+    return filename.substr(0, dot) + ".updated" + filename.substr(dot);
+}
+
+/**
+ * @return Id of the process, so temporary files of different processes do not collide
+ */
+unsigned long process_id() {
+#if defined(__unix__) || defined(__APPLE__)
+    return static_cast<unsigned long>(::getpid());
+#else
+    return 0;
+#endif
 }
 
+/**
+ * Temporary file written in place of a file, which it replaces by commit() once it is complete.
+ * A replacement which is not committed is deleted, so a failed save leaves the old file as it was.
+ * The temporary name contains the process id and a counter, so no existing file is touched.
+ */
+class replacement_file {
+    std::string m_target;
+    std::string m_path;
+    bool m_committed{false};
+
+    static std::string temporary_path(std::string const &target) {
+        static unsigned long created = 0;
+        return target + "." + std::to_string(process_id()) + "." + std::to_string(created++) + ".tmp";
+    }
+
+public:
+    /**
+     * @param target Path to the file to replace
+     */
+    explicit replacement_file(std::string target)
+            : m_target{std::move(target)}, m_path{temporary_path(m_target)} {}
+
+    ~replacement_file() {
+        if (!m_committed) std::remove(m_path.c_str());
+    }
+
+    replacement_file(replacement_file const &) = delete;
+    replacement_file &operator=(replacement_file const &) = delete;
+
+    /**
+     * @return Path to the temporary file
+     */
+    inline std::string const &path() const { return m_path; }
+
+    /**
+     * Renames the temporary file to the target, the file has to be closed
+     * @throws std::runtime_error if the file cannot be renamed
+     */
+    void commit() {
+        if (std::rename(m_path.c_str(), m_target.c_str()) != 0) throw std::runtime_error("Cannot write " + m_target);
+        m_committed = true;
+    }
+};
+
+/**
+ * Saves a file through a replacement_file
+ * @param filename Path to the file
+ * @param save Writes the content to the path it is given
+ * @throws std::runtime_error if the file cannot be written
+ */
+template<typename Save>
+void replace_file(std::string const &filename, Save const &save) {
+    replacement_file file{filename};
+
+    save(file.path());
+    file.commit();
+}
+
+/**
+ * @param csr CSR graph
+ * @return Ids of all edges of the graph
+ */
+edge_ids_t all_edge_ids(csr_graph const &csr) {
+    edge_ids_t all_edges(csr.edge_count());
+    for (std::size_t e = 0; e < all_edges.size(); e++) all_edges[e] = static_cast<csr_graph::edge_id>(e);
+
+    return all_edges;
+}
+
+/**
+ * Saves all edges of a graph in the text format of the input files
+ * @param g Graph to save
+ * @param filename Path to the file, replaced only when the graph is written completely
+ */
 void save_to_file(graph const &g, std::string const &filename) {
-    auto vertex_count = g.vertices().size();
-    auto edge_count = g.edges().size();
-    auto edges_by_vertex = g.get_edges_by_vertex();
+    csr_graph csr{g};
+
+    std::cout << "Saving the graph to " << filename << "." << std::endl;
 
+    replace_file(filename, [&](std::string const &path) {
+        write_result(csr, all_edge_ids(csr), path, result_format::adjacency);
+    });
+
+    std::cout << "Graph is saved to " << filename << "." << std::endl;
+}
+
+/**
+ * Prints the summary of a Borůvka trace and saves it in the Chrome trace-event format
+ * @param trace The trace
+ * @param filename Path to the trace file
+ */
+void save_trace(boruvka_trace const &trace, std::string const &filename) {
+    std::cout << std::endl;
+    trace.write_summary(std::cout);
+    std::cout << std::endl;
 
     std::ofstream file;
     file.open(filename, std::ios::out | std::ios::trunc);
+    trace.write_chrome_trace(file);
 
-    file << vertex_count << " " << edge_count << std::endl;
+    std::cout << "The trace is saved to " << filename << "." << std::endl;
+}
 
-    std::cout << "Saving the graph to " << filename << "." << std::endl;
+/**
+ * Looks up the MST of the input graph in the cache of --cache
+ * @param options Program options with the cache directory and size limit
+ * @param csr Input graph
+ * @param key Fingerprint of the graph
+ * @param tree Receives the MST on a hit
+ * @return True on a hit; a spanning forest of a disconnected graph is a hit only with --forest
+ */
+bool find_cached_mst(program_options const &options, csr_graph const &csr, graph_fingerprint const &key,
+                     edge_ids_t &tree) {
+    mst_cache cache{options.cache, options.cache_limit};
+    auto hit = cache.lookup(csr, key, tree) && (options.forest || tree.size() + 1 >= csr.vertex_count());
+
+    std::cout << "The MST of the graph " << key.to_string() << (hit ? " is" : " is not") << " in the cache."
+              << std::endl;
+
+    return hit;
+}
 
-    for (auto &entry : edges_by_vertex) {
-        file << entry.first << " " << entry.second.size();
+/**
+ * Loads the input graph, computes its MST with the selected engine and saves it to the output file.
+ * With --stream, the output file is opened before the run and the engine writes the edges as it commits them.
+ * With --cache, an MST stored by an earlier run for the same graph is saved instead of computing it
+ * (unless the run is traced), and a computed one is stored.
+ * @param options Program options
+ * @param pool Thread pool for the multi-threaded calculation, nullptr for the single-threaded one
+ * @return Duration of the MST calculation
+ */
+std::chrono::milliseconds run_engine(program_options const &options, thread_pool *pool) {
+    std::string kind = pool != nullptr ? "multi-threaded" : "single-threaded";
 
-        for (auto &edge : entry.second) {
-            file << " ";
-            if (edge->start == entry.first) {
-                file << edge->end;
-            } else {
-                file << edge->start;
+    try {
+        auto csr = load_graph(options);
+
+        graph_fingerprint key{};
+        edge_ids_t tree;
+        if (!options.cache.empty()) {
+            key = fingerprint_graph(csr, &thread_pool::global());
+
+            if (!options.trace && find_cached_mst(options, csr, key, tree)) {
+                unsigned long long sum = 0;
+                for (auto e : tree) sum += csr.weights()[e];
+                print_sum_of_edge_weights(sum);
+
+                std::cout << "Saving the MST to " << options.output << "." << std::endl;
+                write_result(csr, tree, options.output, options.format);
+                std::cout << "MST is saved to " << options.output << "." << std::endl;
+
+                return {};
             }
-            file << ' ' << edge->weight;
         }
-        file << std::endl;
-    }
 
-    file.close();
+        auto engine = options.algorithm == "auto"
+                      ? choose_mst_engine(csr, pool != nullptr)
+                      : make_mst_engine(options.algorithm);
 
-    std::cout << "Graph is saved to " << filename << "." << std::endl;
-}
+        boruvka_trace trace{};
+        if (options.trace) {
+            if (engine->name() == "boruvka")
+                engine = std::make_unique<boruvka_mst>(&trace);
+            else
+                std::cout << "Tracing is only available for the boruvka engine." << std::endl;
+        }
 
-std::chrono::milliseconds run_single() {
-    auto g = load_from_file("graph_data.txt");
+        // after the trace swap, which replaces the engine
+        engine->set_spanning_forest(options.forest);
 
-    try {
-        std::cout << "Starting the single-threaded MST calculation." << std::endl;
+        // a run which fails leaves the previous output file instead of a truncated one
+        std::unique_ptr<replacement_file> stream_file;
+        std::unique_ptr<result_writer> stream;
+        if (options.stream) {
+            stream_file = std::make_unique<replacement_file>(options.output);
+            stream = std::make_unique<result_writer>(csr, stream_file->path(), options.format, true);
+
+            auto writer = stream.get();
+            engine->set_tree_sink([writer](csr_graph::edge_id const *edges, std::size_t count) {
+                writer->add(edges, count);
+            });
+        }
+
+        std::cout << "Starting the " << kind << " MST calculation (" << engine->name() << ")." << std::endl;
 
         auto start = std::chrono::high_resolution_clock::now();
-        auto mst = g.calculate_minimum_spanning_tree();
+        tree = engine->solve(csr, pool);
         auto end = std::chrono::high_resolution_clock::now();
 
         auto total = to_ms(end - start);
 
-        std::cout << "The single-threaded MST calculation took " << total.count() << " ms." << std::endl;
+        std::cout << "The " << kind << " MST calculation took " << total.count() << " ms." << std::endl;
+
+        if (!trace.rounds().empty()) save_trace(trace, "trace.json");
 
-        print_sum_of_edge_weights(mst);
-        save_to_file(mst, "result.txt");
+        unsigned long long sum = 0;
+        for (auto e : tree) sum += csr.weights()[e];
+
+        print_sum_of_edge_weights(sum);
+        if (tree.size() + 1 < csr.vertex_count())
+            std::cout << "The graph has " << csr.vertex_count() - tree.size() << " connected components, "
+                      << options.output << " contains their minimum spanning forest." << std::endl;
+
+        std::cout << "Saving the MST to " << options.output << "." << std::endl;
+
+        if (stream) {
+            stream->finish();
+            stream.reset();
+            stream_file->commit();
+        } else {
+            write_result(csr, tree, options.output, options.format);
+        }
+
+        std::cout << "MST is saved to " << options.output << "." << std::endl;
+
+        if (!options.cache.empty()) {
+            // the MST is saved already, so a full or read-only cache does not fail the run
+            try {
+                mst_cache{options.cache, options.cache_limit}.store(csr, key, tree);
+                std::cout << "The MST is stored in the cache." << std::endl;
+            } catch (std::runtime_error const &error) {
+                std::cout << "The MST is not stored in the cache: " << error.what() << std::endl;
+            }
+        }
 
         return total;
     } catch (std::domain_error const &error) {
         std::cout << error.what();
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
     }
 
     return {};
 }
 
-std::chrono::milliseconds run_parallel() {
-    auto g = load_from_file("graph_data.txt");
+std::chrono::milliseconds run_single(program_options const &options) {
+    return run_engine(options, nullptr);
+}
+
+std::chrono::milliseconds run_parallel(program_options const &options) {
+    return run_engine(options, &thread_pool::global());
+}
 
+/**
+ * Finds the connected components of the input graph with the global thread pool and prints their count
+ * and the size of the largest one
+ * @param options Program options
+ */
+void run_components(program_options const &options) {
     try {
-        std::cout << "Starting the multi-threaded MST calculation." << std::endl;
+        auto csr = load_graph(options);
+
+        std::cout << "Starting the connected components calculation." << std::endl;
 
         auto start = std::chrono::high_resolution_clock::now();
-        auto mst = g.calculate_minimum_spanning_tree_parallel();
+        auto components = connected_components(csr, &thread_pool::global());
         auto end = std::chrono::high_resolution_clock::now();
 
-        auto total = to_ms(end - start);
+        std::cout << "The connected components calculation took " << to_ms(end - start).count() << " ms."
+                  << std::endl;
 
-        std::cout << "The multi-threaded MST calculation took " << total.count() << " ms." << std::endl;
+        std::vector<std::size_t> sizes(components.count);
+        for (auto label : components.labels) ++sizes[label];
 
-        print_sum_of_edge_weights(*mst);
-        save_to_file(*mst, "result.txt");
+        auto largest = sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
 
-        return total;
+        std::cout << "The graph has " << components.count << " connected components, the largest has "
+                  << largest << " vertices." << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
+    }
+}
+
+/**
+ * Computes the MST of the input graph out of core: the edges are streamed from the disk in every pass
+ * and the MST edges are written as an edge list as soon as they are found, to a temporary file which
+ * replaces the output file when the run succeeds
+ * @param options Program options with the input path
+ */
+void run_external(program_options const &options) {
+    try {
+        auto edges = open_edge_stream(options.input);
+
+        // a run which fails, e.g. on a disconnected graph, leaves the previous output file
+        replacement_file output{options.output};
+
+        std::vector<char> buffer(1 << 20);
+        std::ofstream file;
+        file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.open(output.path(), std::ios::out | std::ios::trunc);
+        if (!file.is_open()) throw std::runtime_error("Cannot write " + options.output);
+
+        std::cout << "Starting the out-of-core MST calculation of " << options.input << "." << std::endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto summary = calculate_external_mst(*edges, file);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (!file.flush()) throw std::runtime_error("Cannot write " + options.output);
+        file.close();
+        output.commit();
+
+        std::cout << "The out-of-core MST calculation took " << to_ms(end - start).count() << " ms in "
+                  << summary.passes << " passes over the edges." << std::endl;
+        std::cout << "The sum of edge weights is " << summary.total_weight << "." << std::endl;
+        std::cout << "The MST edges are saved to " << options.output << "." << std::endl;
     } catch (std::domain_error const &error) {
-        std::cout << error.what();
+        std::cout << error.what() << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
     }
+}
 
-    return {};
+/**
+ * Computes the MST of the input graph with Borůvka's algorithm in worker processes and saves it to the output file
+ * @param options Program options with the worker count
+ */
+void run_distributed(program_options const &options) {
+    try {
+        // forked before the loader starts the threads of the global pool
+        distributed_boruvka workers{options.workers > 0 ? options.workers : thread_pool::default_thread_count()};
+
+        auto csr = load_graph(options);
+
+        std::cout << "Starting the MST calculation in " << workers.size() << " worker processes." << std::endl;
+
+        distributed_summary summary{};
+        auto start = std::chrono::high_resolution_clock::now();
+        auto tree = workers.solve(csr, options.forest, &summary);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "The distributed MST calculation took " << to_ms(end - start).count() << " ms in "
+                  << summary.rounds << " rounds, " << summary.bytes << " bytes were exchanged with "
+                  << summary.workers << " workers." << std::endl;
+
+        unsigned long long sum = 0;
+        for (auto e : tree) sum += csr.weights()[e];
+        print_sum_of_edge_weights(sum);
+
+        std::cout << "Saving the MST to " << options.output << "." << std::endl;
+        write_result(csr, tree, options.output, options.format);
+        std::cout << "MST is saved to " << options.output << "." << std::endl;
+    } catch (std::domain_error const &error) {
+        std::cout << error.what() << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
+    }
 }
 
-void compare() {
-    auto single_thread_ms = run_single();
+/**
+ * Checks that the MST saved in the output file is a minimum spanning tree (or forest with --forest) of the input graph
+ * and optionally saves a certificate: a "<start> <end> <weight> <tree start> <tree end> <tree weight>" line for every
+ * non-tree edge with the heaviest tree edge on the cycle it closes
+ * @param options Program options with the input, output and certificate paths
+ * @return True if the tree is valid
+ */
+bool run_verify(program_options const &options) {
+    try {
+        auto csr = load_graph(options);
+
+        std::cout << "Loading the MST from " << options.output << "." << std::endl;
+        auto tree = load_result(options.output);
+
+        std::cout << "Verifying the MST." << std::endl;
+
+        std::vector<csr_graph::edge_id> witnesses;
+        auto start = std::chrono::high_resolution_clock::now();
+        auto verdict = verify_mst(csr, tree, &thread_pool::global(),
+                                  options.certificate.empty() ? nullptr : &witnesses);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "The verification took " << to_ms(end - start).count() << " ms." << std::endl;
+
+        if (verdict.valid && !options.forest && tree.size() + 1 != csr.vertex_count()) {
+            verdict.valid = false;
+            verdict.problem = "The graph is not connected, use --forest to verify a minimum spanning forest";
+        }
+
+        if (!verdict.valid) {
+            std::cout << "The MST is not valid: " << verdict.problem << "." << std::endl;
+            return false;
+        }
+
+        std::cout << "The MST is valid, " << tree.size() << " edges." << std::endl;
+
+        if (!options.certificate.empty()) {
+            std::vector<char> buffer(1 << 20);
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.open(options.certificate, std::ios::out | std::ios::trunc);
+
+            for (std::size_t e = 0; e < witnesses.size(); e++) {
+                if (witnesses[e] == csr_graph::no_edge) continue;
+
+                auto x = csr.to_edge(static_cast<csr_graph::edge_id>(e));
+                auto w = csr.to_edge(witnesses[e]);
+                file << x.start << ' ' << x.end << ' ' << x.weight << ' ' << w.start << ' ' << w.end << ' '
+                     << w.weight << '\n';
+            }
+
+            if (!file.flush()) throw std::runtime_error("Cannot write " + options.certificate);
+
+            std::cout << "The certificate is saved to " << options.certificate << "." << std::endl;
+        }
+
+        return true;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
+    }
+
+    return false;
+}
+
+/**
+ * Solves all jobs of the manifest with the global thread pool, the report goes to the standard output
+ * @param options Program options with the manifest, the engine and the output format
+ */
+void run_batch(program_options const &options) {
+    batch_options batch{options.algorithm, options.format, options.forest, options.concurrency, options.cache,
+                        options.cache_limit};
+
+    std::ifstream file;
+    if (options.manifest != "-") {
+        file.open(options.manifest);
+        if (!file) {
+            std::cout << "Cannot open " << options.manifest << std::endl;
+            return;
+        }
+    }
+
+    batch_summary summary{};
+    try {
+        summary = run_batch(options.manifest == "-" ? std::cin : file, std::cout, batch, thread_pool::global());
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
+        return;
+    }
+
+    std::cout << std::endl << "Solved " << summary.jobs - summary.failed << " of " << summary.jobs << " jobs in "
+              << std::fixed << std::setprecision(1) << summary.wall_ms << " ms";
+    if (summary.wall_ms > 0)
+        std::cout << " (" << summary.jobs / (summary.wall_ms / 1000) << " jobs/s, "
+                  << summary.edges / (summary.wall_ms / 1000) << " edges/s)";
+    std::cout << "." << std::endl << "Job latency: median " << summary.median_latency_ms << " ms, p95 "
+              << summary.p95_latency_ms << " ms, max " << summary.max_latency_ms << " ms." << std::endl;
+}
+
+/**
+ * Converts a CSR graph with all of its edges
+ * @param csr CSR graph
+ * @return Graph with the original vertex labels
+ */
+graph to_full_graph(csr_graph const &csr) {
+    return csr.to_graph(all_edge_ids(csr));
+}
+
+/**
+ * Checks that the vertices of a graph are numbered 0 to n - 1, which the text format requires
+ * @param csr CSR graph
+ * @throws std::invalid_argument naming the first vertex out of order
+ */
+void check_dense_labels(csr_graph const &csr) {
+    auto labels = csr.labels();
+
+    for (std::size_t v = 0; v < csr.vertex_count(); v++) {
+        if (labels[v] != v)
+            throw std::invalid_argument("The updates add vertex " + std::to_string(labels[v]) +
+                                        ", but the vertices of a text graph are numbered from 0 without gaps, "
+                                        "so the next new vertex has to be " + std::to_string(v) + ".");
+    }
+}
+
+/**
+ * Loads the input graph and its MST saved in the output file in any --format, applies the changes of the delta file to both,
+ * saves the MST back in the --format and the graph, in its original format, to the --updated-graph file. Both are replaced only when
+ * they are written completely, and nothing is saved if a text graph would get a vertex outside of 0 to n - 1.
+ * @param options Program options with the input, delta and updated graph paths
+ */
+void run_update(program_options const &options) {
+    try {
+        if (!fexists(options.output)) {
+            std::cout << "Looks like there is no MST to update!\nYou should run --single or --parallel first!"
+                      << std::endl;
+            return;
+        }
+
+        auto binary = fexists(options.input) && is_binary_graph_file(options.input);
+        auto g = to_full_graph(load_graph(options));
+        graph mst{};
+        for (auto const &e : load_result(options.output)) {
+            mst.add_vertex(e.start);
+            mst.add_vertex(e.end);
+            mst.add_edge(e);
+        }
+        auto updates = load_edge_updates(options.delta);
+
+        std::cout << "Applying " << updates.size() << " edge updates from " << options.delta << "." << std::endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        dynamic_mst dynamic{g, mst};
+
+        for (auto const &update : updates) {
+            if (update.erase)
+                dynamic.erase(update.e.start, update.e.end);
+            else
+                dynamic.update_weight(update.e);
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        csr_graph full{dynamic.full_graph()};
+        if (!binary) check_dense_labels(full);
+
+        std::cout << "The MST update took " << to_ms(end - start).count() << " ms." << std::endl;
+
+        auto updated = dynamic.to_graph();
+
+        print_sum_of_edge_weights(updated);
+        if (updated.edges().size() + 1 != updated.vertices().size())
+            std::cout << "The graph is not connected anymore, " << options.output << " contains a spanning forest."
+                      << std::endl;
+
+        auto graph_output = options.updated_graph.empty() ? updated_filename(options.input) : options.updated_graph;
+
+        csr_graph tree{updated};
+
+        std::cout << "Saving the MST to " << options.output << "." << std::endl;
+        replace_file(options.output, [&](std::string const &path) {
+            write_result(tree, all_edge_ids(tree), path, options.format);
+        });
+        std::cout << "MST is saved to " << options.output << "." << std::endl;
+
+        if (binary) {
+            std::cout << "Saving the binary graph to " << graph_output << "." << std::endl;
+            replace_file(graph_output, [&](std::string const &path) { save_binary_graph(full, path); });
+            std::cout << "Graph is saved to " << graph_output << "." << std::endl;
+        } else {
+            save_to_file(dynamic.full_graph(), graph_output);
+        }
+    } catch (std::invalid_argument const &error) {
+        std::cout << error.what() << std::endl;
+    } catch (std::runtime_error const &error) {
+        std::cout << error.what() << std::endl;
+    }
+}
+
+/**
+ * Runs the single-threaded and the multi-threaded calculation and compares their durations. Both compute
+ * the MST, --cache would let the second run find the MST of the first one.
+ * @param options Program options
+ */
+void compare(program_options options) {
+    if (!options.cache.empty()) {
+        std::cout << "--compare does not use the cache, both runs compute the MST." << std::endl;
+        options.cache.clear();
+    }
+
+    auto single_thread_ms = run_single(options);
 
     std::cout << std::endl << "================================================" << std::endl << std::endl;
 
-    auto multi_thread_ms = run_parallel();
+    auto multi_thread_ms = run_parallel(options);
 
     print_comparison(single_thread_ms, multi_thread_ms);
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        std::cout << "\n\nUsage: ./main <command>\n\n";
-        std::cout << "For more info: ./main --help\n\n";
+    std::string arg{};
+    program_options options{};
+    bool format_given = false;
+
+    for (int i = 1; i < argc; i++) {
+        auto current = std::string(argv[i]);
+        std::string value;
+
+        if (read_option(current, "--threads", value)) {
+            try {
+                thread_pool::set_global_thread_count(std::stoul(value));
+            } catch (std::logic_error const &) {
+                std::cout << "Invalid thread count " << value << std::endl;
+                return 1;
+            }
+        } else if (read_option(current, "--algorithm", value)) {
+            if (value != "auto" && make_mst_engine(value) == nullptr) {
+                std::cout << "Unknown algorithm " << value << std::endl;
+                return 1;
+            }
+            options.algorithm = value;
+        } else if (read_option(current, "--input", value)) {
+            options.input = value;
+        } else if (read_option(current, "--delta", value)) {
+            options.delta = value;
+        } else if (read_option(current, "--updated-graph", value)) {
+            options.updated_graph = value;
+        } else if (read_option(current, "--manifest", value)) {
+            options.manifest = value;
+        } else if (read_option(current, "--concurrency", value)) {
+            try {
+                options.concurrency = std::stoul(value);
+            } catch (std::logic_error const &) {
+                std::cout << "Invalid job count " << value << std::endl;
+                return 1;
+            }
+        } else if (read_option(current, "--workers", value)) {
+            try {
+                options.workers = std::stoul(value);
+            } catch (std::logic_error const &) {
+                std::cout << "Invalid worker count " << value << std::endl;
+                return 1;
+            }
+        } else if (read_option(current, "--cache", value)) {
+            options.cache = value;
+        } else if (read_option(current, "--cache-limit", value)) {
+            try {
+                auto mebibytes = std::stoull(value);
+                if (mebibytes > UINT64_MAX >> 20) throw std::out_of_range(value);
+
+                options.cache_limit = std::uint64_t{mebibytes} << 20;
+            } catch (std::logic_error const &) {
+                std::cout << "Invalid cache size " << value << std::endl;
+                return 1;
+            }
+        } else if (read_option(current, "--certificate", value)) {
+            options.certificate = value;
+        } else if (read_option(current, "--output", value)) {
+            options.output = value;
+        } else if (read_option(current, "--format", value)) {
+            if (!parse_result_format(value, options.format)) {
+                std::cout << "Unknown output format " << value << std::endl;
+                return 1;
+            }
+            format_given = true;
+        } else if (read_option(current, "--vertices", value) || read_option(current, "--edges", value) ||
+                   read_option(current, "--min-weight", value) || read_option(current, "--max-weight", value) ||
+                   read_option(current, "--seed", value)) {
+            try {
+                auto number = std::stoull(value);
+                auto name = current.substr(0, current.find('='));
+
+                if (name == "--vertices") {
+                    options.generator.vertex_count = number;
+                } else if (name == "--edges") {
+                    options.generator.edge_count = number;
+                } else if (name == "--min-weight") {
+                    options.generator.min_weight = number;
+                } else if (name == "--max-weight") {
+                    options.generator.max_weight = number;
+                } else {
+                    options.generator.seed = number;
+                    options.seeded = true;
+                }
+            } catch (std::logic_error const &) {
+                std::cout << "Invalid number " << current << std::endl;
+                return 1;
+            }
+        } else if (read_option(current, "--distribution", value)) {
+            if (!parse_weight_distribution(value, options.generator.distribution)) {
+                std::cout << "Unknown distribution " << value << std::endl;
+                return 1;
+            }
+        } else if (current == "--trace") {
+            options.trace = true;
+        } else if (current == "--forest") {
+            options.forest = true;
+        } else if (current == "--stream") {
+            options.stream = true;
+        } else if (current == "--no-checksum") {
+            options.verify_checksum = false;
+        } else if (arg.empty()) {
+            arg = current;
+        } else {
+            arg.clear();
+            break;
+        }
+    }
+
+    if (options.stream && options.format == result_format::adjacency) {
+        std::cout << "--stream needs --format=edges or --format=binary" << std::endl;
+        return 1;
+    }
+
+    // the out-of-core run appends every edge as soon as it is committed, so it writes an edge list only
+    if (arg == "--external" && format_given && options.format != result_format::edge_list) {
+        std::cout << "--external saves the MST as an edge list, it needs --format=edges or no --format" << std::endl;
         return 1;
     }
 
-    auto arg = std::string(argv[1]);
+    if (arg.empty()) {
+        std::cout << "\n\nUsage: ./main <command> [<options>]\n\n";
+        std::cout << "For more info: ./main --help\n\n";
+        return 1;
+    }
 
     if (arg == "--help") {
         print_help();
@@ -238,22 +1000,56 @@ int main(int argc, char *argv[]) {
     }
 
     if (arg == "--generate") {
-        save_to_file(generate_random_graph(), "graph_data.txt");
+        generate(options);
+        return 0;
+    }
+
+    if (arg == "--convert") {
+        convert(options);
         return 0;
     }
 
     if (arg == "--single") {
-        run_single();
+        run_single(options);
         return 0;
     }
 
     if (arg == "--parallel") {
-        run_parallel();
+        run_parallel(options);
+        return 0;
+    }
+
+    if (arg == "--components") {
+        run_components(options);
+        return 0;
+    }
+
+    if (arg == "--external") {
+        run_external(options);
+        return 0;
+    }
+
+    if (arg == "--distributed") {
+        run_distributed(options);
+        return 0;
+    }
+
+    if (arg == "--verify") {
+        return run_verify(options) ? 0 : 1;
+    }
+
+    if (arg == "--batch") {
+        run_batch(options);
+        return 0;
+    }
+
+    if (arg == "--update") {
+        run_update(options);
         return 0;
     }
 
     if (arg == "--compare") {
-        compare();
+        compare(options);
         return 0;
     }
 
@@ -0,0 +1,73 @@
+#include "mapped_file.h"
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+mapped_file::mapped_file(std::string const &filename) {
+    auto fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + filename);
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read the size of " + filename);
+    }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+
+    if (m_size > 0) {
+        auto address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + filename);
+        }
+
+        m_data = static_cast<char const *>(address);
+        m_mapped = true;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+    if (m_mapped) ::munmap(const_cast<char *>(m_data), m_size);
+}
+
+void mapped_file::advise_sequential() const {
+    if (m_mapped) ::madvise(const_cast<char *>(m_data), m_size, MADV_SEQUENTIAL);
+}
+
+#else
+
+#include <fstream>
+
+mapped_file::mapped_file(std::string const &filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Cannot open " + filename);
+
+    m_size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+
+    auto buffer = new char[m_size > 0 ? m_size : 1];
+    if (!file.read(buffer, static_cast<std::streamsize>(m_size))) {
+        delete[] buffer;
+        throw std::runtime_error("Cannot read " + filename);
+    }
+
+    m_data = buffer;
+}
+
+mapped_file::~mapped_file() {
+    delete[] m_data;
+}
+
+void mapped_file::advise_sequential() const {}
+
+#endif
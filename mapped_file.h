@@ -0,0 +1,37 @@
+#ifndef MINIMUM_SPANNING_TREE_MAPPED_FILE_H
+#define MINIMUM_SPANNING_TREE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only view of a whole file. On POSIX systems the file is memory-mapped, so its pages are loaded lazily
+ * by the kernel and shared with the page cache; elsewhere the file is read into an owned buffer.
+ */
+class mapped_file {
+    char const *m_data{nullptr};
+    std::size_t m_size{0};
+    bool m_mapped{false};
+
+public:
+    /**
+     * Maps the file
+     * @param filename Path to the file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit mapped_file(std::string const &filename);
+    ~mapped_file();
+
+    mapped_file(mapped_file const &) = delete;
+    mapped_file &operator=(mapped_file const &) = delete;
+
+    inline char const *data() const { return m_data; }
+    inline std::size_t size() const { return m_size; }
+
+    /**
+     * Tells the kernel that the file will be read front to back, so it can read ahead aggressively
+     */
+    void advise_sequential() const;
+};
+
+#endif //MINIMUM_SPANNING_TREE_MAPPED_FILE_H
@@ -0,0 +1,253 @@
+#include "mst_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include "result_writer.h"
+#include "thread_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#endif
+
+namespace {
+    const std::uint64_t low_seed = 0x243F6A8885A308D3ULL, high_seed = 0x13198A2E03707344ULL;
+    const std::uint64_t vertex_tag = 0xA4093822299F31D0ULL;
+
+    /**
+     * Vertices or edges hashed by one task
+     */
+    const std::size_t hash_chunk_size = 1 << 16;
+
+    const std::string entry_suffix = ".mst";
+
+    /**
+     * Finalizer of SplitMix64, every input bit affects every output bit
+     */
+    inline std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    inline std::uint64_t hash_edge(std::uint64_t seed, std::uint64_t start, std::uint64_t end, std::uint64_t weight) {
+        return mix(mix(mix(seed ^ start) + end) + weight);
+    }
+
+    /**
+     * Adds up hash(lane seed, i) over [0, count) in both lanes, in chunks on the pool if there is one
+     */
+    template<typename Hash>
+    std::pair<std::uint64_t, std::uint64_t> sum_hashes(std::size_t count, thread_pool *pool, Hash const &hash) {
+        std::atomic<std::uint64_t> low{0}, high{0};
+
+        auto chunk = [&](std::size_t begin, std::size_t end) {
+            std::uint64_t chunk_low = 0, chunk_high = 0;
+            for (auto i = begin; i < end; i++) {
+                chunk_low += hash(low_seed, i);
+                chunk_high += hash(high_seed, i);
+            }
+            low += chunk_low;
+            high += chunk_high;
+        };
+
+        if (pool == nullptr) {
+            chunk(0, count);
+        } else {
+            pool->parallel_for(0, count, hash_chunk_size, chunk);
+        }
+
+        return {low.load(), high.load()};
+    }
+
+    /**
+     * @return Id of the process, so temporary entries of different processes do not collide
+     */
+    unsigned long process_id();
+}
+
+std::string graph_fingerprint::to_string() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(32, '0');
+
+    for (int i = 0; i < 16; i++) {
+        text[15 - i] = digits[(high >> (4 * i)) & 0xF];
+        text[31 - i] = digits[(low >> (4 * i)) & 0xF];
+    }
+
+    return text;
+}
+
+graph_fingerprint fingerprint_graph(csr_graph const &g, thread_pool *pool) {
+    auto labels = g.labels();
+    auto sources = g.sources();
+    auto targets = g.targets();
+    auto weights = g.weights();
+
+    auto vertices = sum_hashes(g.vertex_count(), pool, [labels](std::uint64_t seed, std::size_t v) {
+        return mix(seed ^ mix(labels[v] ^ vertex_tag));
+    });
+
+    // labels are sorted like the dense ids, so the smaller id has the smaller label
+    auto edges = sum_hashes(g.edge_count(), pool, [&](std::uint64_t seed, std::size_t e) {
+        auto a = sources[e], b = targets[e];
+        if (b < a) std::swap(a, b);
+        return hash_edge(seed, labels[a], labels[b], weights[e]);
+    });
+
+    graph_fingerprint key{};
+    key.low = mix(vertices.first + mix(edges.first ^ g.edge_count()));
+    key.high = mix(vertices.second + mix(edges.second ^ g.vertex_count()));
+
+    return key;
+}
+
+std::string mst_cache::entry_path(graph_fingerprint const &key) const {
+    return m_directory + "/" + key.to_string() + entry_suffix;
+}
+
+bool mst_cache::lookup(csr_graph const &g, graph_fingerprint const &key, std::vector<csr_graph::edge_id> &tree) const {
+    auto path = entry_path(key);
+
+    std::vector<edge> edges;
+    try {
+        edges = load_result(path);
+    } catch (std::runtime_error const &) {
+        // missing, evicted meanwhile or damaged, the MST is computed again and the entry replaced
+        return false;
+    }
+
+    if (edges.size() >= std::max<std::size_t>(g.vertex_count(), 1)) return false;
+
+    tree.clear();
+    tree.reserve(edges.size());
+
+    for (auto const &x : edges) {
+        auto a = g.find_vertex(x.start), b = g.find_vertex(x.end);
+        auto e = a < g.vertex_count() && b < g.vertex_count() ? g.find_edge(a, b) : csr_graph::no_edge;
+
+        if (e == csr_graph::no_edge || g.weights()[e] != x.weight) return false;
+        tree.push_back(e);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    ::utime(path.c_str(), nullptr);
+#endif
+
+    return true;
+}
+
+void mst_cache::store(csr_graph const &g, graph_fingerprint const &key,
+                      std::vector<csr_graph::edge_id> const &tree) const {
+    static std::atomic<unsigned long> stored{0};
+
+    auto path = entry_path(key);
+    auto temporary = path + "." + std::to_string(process_id()) + "." + std::to_string(stored++) + ".tmp";
+
+    try {
+        write_result(g, tree, temporary, result_format::binary);
+    } catch (std::runtime_error const &) {
+        std::remove(temporary.c_str());
+        throw;
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Cannot write " + path);
+    }
+
+    evict(path);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+    unsigned long process_id() {
+        return static_cast<unsigned long>(::getpid());
+    }
+
+    std::uint64_t file_size(std::string const &path) {
+        struct stat info{};
+        return ::stat(path.c_str(), &info) == 0 ? static_cast<std::uint64_t>(info.st_size) : 0;
+    }
+}
+
+mst_cache::mst_cache(std::string directory, std::uint64_t size_limit)
+        : m_directory{std::move(directory)}, m_size_limit{size_limit} {
+    if (::mkdir(m_directory.c_str(), 0777) != 0 && errno != EEXIST)
+        throw std::runtime_error("Cannot create the cache directory " + m_directory);
+
+    struct stat info{};
+    if (::stat(m_directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+        throw std::runtime_error(m_directory + " is not a directory");
+}
+
+void mst_cache::evict(std::string const &keep) const {
+    struct entry {
+        std::string path;
+        std::uint64_t size;
+        time_t used;
+    };
+
+    auto directory = ::opendir(m_directory.c_str());
+    if (directory == nullptr) return;
+
+    std::vector<entry> entries;
+    std::uint64_t total = 0;
+
+    while (auto item = ::readdir(directory)) {
+        std::string name = item->d_name;
+        if (name.size() <= entry_suffix.size() ||
+            name.compare(name.size() - entry_suffix.size(), entry_suffix.size(), entry_suffix) != 0)
+            continue;
+
+        struct stat info{};
+        auto path = m_directory + "/" + name;
+        if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+
+        // modification times have a resolution of seconds, the entry just stored is the newest anyway
+        if (path == keep) continue;
+
+        entries.push_back(entry{path, static_cast<std::uint64_t>(info.st_size), info.st_mtime});
+        total += entries.back().size;
+    }
+    ::closedir(directory);
+
+    std::sort(entries.begin(), entries.end(), [](entry const &a, entry const &b) {
+        return a.used < b.used || (a.used == b.used && a.path < b.path);
+    });
+
+    total += file_size(keep);
+
+    // another process may delete the same entry at the same time, which is fine
+    for (auto it = entries.begin(); it != entries.end() && total > m_size_limit; ++it) {
+        ::unlink(it->path.c_str());
+        total -= it->size;
+    }
+}
+
+#else
+
+namespace {
+    unsigned long process_id() {
+        return 0;
+    }
+}
+
+mst_cache::mst_cache(std::string directory, std::uint64_t size_limit)
+        : m_directory{std::move(directory)}, m_size_limit{size_limit} {}
+
+void mst_cache::evict(std::string const &) const {
+    // listing a directory needs the POSIX API, the entries are not limited elsewhere
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef MINIMUM_SPANNING_TREE_MST_CACHE_H
+#define MINIMUM_SPANNING_TREE_MST_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+class thread_pool;
+
+/**
+ * 128-bit fingerprint of the vertex labels and the edges of a graph
+ */
+struct graph_fingerprint {
+    std::uint64_t high;
+    std::uint64_t low;
+
+    /**
+     * @return The fingerprint as 32 hexadecimal digits
+     */
+    std::string to_string() const;
+};
+
+/**
+ * Hashes a graph independently of the order of its vertices and edges, and so of the file format and the loader.
+ *
+ * Every vertex label and every edge, as (smaller label, larger label, weight), is hashed on its own in two
+ * independently seeded lanes and the hashes are added up, so the edges are hashed in parallel chunks without
+ * sorting them. The CSR graph holds every edge once, which makes the sums a hash of the edge set.
+ * @param g CSR graph
+ * @param pool Pool hashing the chunks, nullptr hashes in the calling thread
+ * @return The fingerprint
+ */
+graph_fingerprint fingerprint_graph(csr_graph const &g, thread_pool *pool);
+
+/**
+ * On-disk cache of MSTs keyed by the fingerprint of their graph.
+ *
+ * Every entry is an MST file in the binary format of result_writer named "<fingerprint>.mst", written to
+ * a temporary file and renamed, so readers never see a partial entry and several processes or threads may share
+ * the directory. The modification time of an entry is its last use: a hit touches it, and after every store
+ * the least recently used entries are deleted until the entries fit into the size limit.
+ */
+class mst_cache {
+    std::string m_directory;
+    std::uint64_t m_size_limit;
+
+    /**
+     * Deletes the least recently used entries until the rest fits into the size limit
+     * @param keep Path to the entry just stored, which is kept even if it alone exceeds the limit
+     */
+    void evict(std::string const &keep) const;
+
+public:
+    /**
+     * Opens the cache, creating the directory if it does not exist
+     * @param directory Path to the cache directory
+     * @param size_limit Total size of the entries in bytes
+     * @throws std::runtime_error if the directory cannot be created
+     */
+    mst_cache(std::string directory, std::uint64_t size_limit);
+
+    /**
+     * @param key Fingerprint of a graph
+     * @return Path to the entry of the graph
+     */
+    std::string entry_path(graph_fingerprint const &key) const;
+
+    /**
+     * Looks up the MST of a graph and marks the entry as used
+     * @param g CSR graph
+     * @param key Fingerprint of the graph, see fingerprint_graph()
+     * @param tree Receives the ids of the MST edges on a hit
+     * @return False if there is no entry or it does not fit the graph
+     */
+    bool lookup(csr_graph const &g, graph_fingerprint const &key, std::vector<csr_graph::edge_id> &tree) const;
+
+    /**
+     * Stores the MST of a graph and evicts old entries
+     * @param g CSR graph
+     * @param key Fingerprint of the graph
+     * @param tree Ids of the MST edges
+     * @throws std::runtime_error if the entry cannot be written
+     */
+    void store(csr_graph const &g, graph_fingerprint const &key, std::vector<csr_graph::edge_id> const &tree) const;
+};
+
+#endif //MINIMUM_SPANNING_TREE_MST_CACHE_H
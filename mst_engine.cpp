@@ -0,0 +1,54 @@
+#include "mst_engine.h"
+#include "arena.h"
+#include <stdexcept>
+#include "boruvka.h"
+
+edge_ids_t mst_engine::solve(csr_graph const &g, thread_pool *pool) const {
+    edge_ids_t tree;
+
+    if (m_scratch == nullptr) {
+        arena scratch;
+        tree = run(g, pool, scratch);
+    } else {
+        m_scratch->reset();
+        tree = run(g, pool, *m_scratch);
+    }
+
+    if (m_sink && !streams_tree()) m_sink(tree.data(), tree.size());
+
+    // a forest has one edge less than vertices per component
+    if (!m_forest && g.vertex_count() > 0 && tree.size() + 1 != g.vertex_count())
+        throw std::domain_error("MST could not be found!");
+
+    return tree;
+}
+
+edge_ids_t boruvka_mst::run(csr_graph const &g, thread_pool *pool, arena &scratch) const {
+    boruvka_engine engine{g, &scratch};
+    engine.set_trace(m_trace);
+    engine.set_spanning_forest(true); // solve() checks the result
+    engine.set_tree_sink(tree_sink());
+    return pool != nullptr ? engine.run_parallel(*pool) : engine.run();
+}
+
+std::unique_ptr<mst_engine> make_mst_engine(std::string const &name) {
+    if (name == "boruvka") return std::make_unique<boruvka_mst>();
+    if (name == "contracting-boruvka") return std::make_unique<contracting_boruvka_mst>();
+    if (name == "kruskal") return std::make_unique<kruskal_mst>();
+    if (name == "filter-kruskal") return std::make_unique<filter_kruskal_mst>();
+    if (name == "prim") return std::make_unique<prim_mst>();
+
+    return nullptr;
+}
+
+std::unique_ptr<mst_engine> choose_mst_engine(csr_graph const &g, bool parallel) {
+    if (parallel) return std::make_unique<boruvka_mst>();
+
+    double vertices = g.vertex_count();
+    double edges = g.edge_count();
+
+    if (edges * 16 >= vertices * (vertices - 1)) return std::make_unique<prim_mst>();
+    if (edges <= 2 * vertices) return std::make_unique<kruskal_mst>();
+
+    return std::make_unique<filter_kruskal_mst>();
+}
@@ -0,0 +1,181 @@
+#ifndef MINIMUM_SPANNING_TREE_MST_ENGINE_H
+#define MINIMUM_SPANNING_TREE_MST_ENGINE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+class arena;
+class boruvka_trace;
+class thread_pool;
+
+typedef std::vector<csr_graph::edge_id> edge_ids_t;
+
+/**
+ * Receives a batch of MST edge ids
+ */
+typedef std::function<void(csr_graph::edge_id const *, std::size_t)> tree_sink_t;
+
+/**
+ * Strategy interface of the MST algorithms. Every engine computes a minimum spanning tree of a CSR graph
+ * using csr_graph::lighter() to break ties. A disconnected graph makes the engine throw std::domain_error,
+ * unless it is asked for a minimum spanning forest: the union of the MSTs of all components.
+ */
+class mst_engine {
+    arena *m_scratch{nullptr};
+    bool m_forest{false};
+    tree_sink_t m_sink{};
+
+protected:
+    /**
+     * Computes the minimum spanning forest, see solve()
+     * @param scratch Arena for all temporary buffers of the run, reset before the call
+     */
+    virtual edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const = 0;
+
+    /**
+     * @return True if run() passes the edges to tree_sink() itself as it commits them,
+     *         otherwise solve() passes the whole tree once run() returns
+     */
+    virtual bool streams_tree() const { return false; }
+
+    /**
+     * @return The sink set by set_tree_sink(), nullptr if there is none
+     */
+    inline tree_sink_t const *tree_sink() const { return m_sink ? &m_sink : nullptr; }
+
+public:
+    virtual ~mst_engine() = default;
+
+    virtual std::string name() const = 0;
+
+    /**
+     * Makes the engine keep its temporary buffers in an arena which outlives the runs. Every run resets it,
+     * so repeated runs on graphs of similar size reuse the same memory instead of allocating it again.
+     * The engine must not run in several threads at once while it shares an arena.
+     * @param scratch The arena, nullptr gives every run an arena of its own
+     */
+    inline void set_scratch(arena *scratch) { m_scratch = scratch; }
+
+    /**
+     * Makes the engine accept disconnected graphs and return their minimum spanning forest
+     * @param forest True to return a forest, false to throw std::domain_error if the graph is not connected
+     */
+    inline void set_spanning_forest(bool forest) { m_forest = forest; }
+
+    inline bool spanning_forest() const { return m_forest; }
+
+    /**
+     * Makes the engine pass the MST edges to a sink while it runs, e.g. to write them out before the run ends.
+     * Borůvka engines pass the edges of every round as soon as they are committed, the others pass
+     * the whole tree at the end of the run. On a disconnected graph the spanning forest is passed
+     * before solve() throws.
+     * @param sink Callable receiving the edges in batches, an empty function removes the sink
+     */
+    inline void set_tree_sink(tree_sink_t sink) { m_sink = std::move(sink); }
+
+    /**
+     * Computes the MST
+     * @param g CSR graph
+     * @param pool Pool for the parallel parts of the engine, nullptr runs everything in the calling thread
+     * @return Ids of the MST edges, of the minimum spanning forest edges in the spanning forest mode
+     * @throws std::domain_error if the graph is not connected, unless in the spanning forest mode
+     */
+    edge_ids_t solve(csr_graph const &g, thread_pool *pool) const;
+};
+
+/**
+ * Borůvka's algorithm, see boruvka_engine
+ */
+class boruvka_mst : public mst_engine {
+    boruvka_trace *m_trace;
+
+protected:
+    edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const override;
+
+    inline bool streams_tree() const override { return true; }
+
+public:
+    /**
+     * @param trace Receives the rounds of every run, see boruvka_engine::set_trace()
+     */
+    explicit boruvka_mst(boruvka_trace *trace = nullptr) : m_trace{trace} {}
+
+    inline std::string name() const override { return "boruvka"; }
+};
+
+/**
+ * Borůvka's algorithm contracting the graph after every round: the components become super-vertices with
+ * dense ids, self-loops are dropped and only the lightest of all parallel edges between two super-vertices
+ * is kept. Later rounds therefore touch geometrically less data, which pays off on dense graphs where most
+ * edges end up inside a component after a round or two.
+ */
+class contracting_boruvka_mst : public mst_engine {
+protected:
+    edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const override;
+
+    inline bool streams_tree() const override { return true; }
+
+public:
+    inline std::string name() const override { return "contracting-boruvka"; }
+};
+
+/**
+ * Kruskal's algorithm: sorts all edges with a (parallel) radix sort and adds them in order
+ * unless they close a cycle
+ */
+class kruskal_mst : public mst_engine {
+protected:
+    edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const override;
+
+public:
+    inline std::string name() const override { return "kruskal"; }
+};
+
+/**
+ * Filter-Kruskal (Osipov, Sanders, Singler): partitions the edges around a pivot like quicksort, processes
+ * the light half first and filters out heavy edges whose endpoints are already connected before recursing,
+ * so most heavy edges of a sparse graph are never sorted at all.
+ */
+class filter_kruskal_mst : public mst_engine {
+protected:
+    edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const override;
+
+public:
+    inline std::string name() const override { return "filter-kruskal"; }
+};
+
+/**
+ * Prim's algorithm with an indexed 4-ary heap of the vertices, best suited to dense graphs.
+ * The tree is grown again from every vertex not reached yet, so each component gets its own.
+ */
+class prim_mst : public mst_engine {
+protected:
+    edge_ids_t run(csr_graph const &g, thread_pool *pool, arena &scratch) const override;
+
+public:
+    inline std::string name() const override { return "prim"; }
+};
+
+/**
+ * Creates an engine by name: boruvka, contracting-boruvka, kruskal, prim or filter-kruskal.
+ * "auto" is not accepted here, see choose_mst_engine().
+ * @param name Engine name
+ * @return The engine or nullptr if the name is unknown
+ */
+std::unique_ptr<mst_engine> make_mst_engine(std::string const &name);
+
+/**
+ * Picks an engine by the shape of the graph:
+ * parallel runs use Borůvka (the only engine which scales with the thread count),
+ * dense graphs (at least 1/8 of all vertex pairs connected) use Prim,
+ * very sparse graphs (average degree up to 4) use Kruskal, and the rest Filter-Kruskal.
+ * @param g CSR graph
+ * @param parallel True if the engine will be given a thread pool
+ * @return The engine
+ */
+std::unique_ptr<mst_engine> choose_mst_engine(csr_graph const &g, bool parallel);
+
+#endif //MINIMUM_SPANNING_TREE_MST_ENGINE_H
@@ -0,0 +1,354 @@
+#include "mst_verify.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include "connected_components.h"
+#include "radix_sort.h"
+#include "union_find.h"
+
+namespace {
+    typedef csr_graph::vertex_id vertex_id;
+    typedef csr_graph::edge_id edge_id;
+
+    const std::uint8_t unvisited = 0, open = 1, finished = 2;
+
+    std::string describe(csr_graph const &g, edge_id e) {
+        auto x = g.to_edge(e);
+        return "(" + std::to_string(x.start) + ", " + std::to_string(x.end) + ", " + std::to_string(x.weight) + ")";
+    }
+
+    mst_verification invalid(std::string problem) {
+        mst_verification verdict{};
+        verdict.valid = false;
+        verdict.problem = std::move(problem);
+        return verdict;
+    }
+
+    /**
+     * Tree edge with its weight, so comparing two of them does not touch the edge arrays of the graph
+     */
+    struct weighted_edge {
+        edge_id id;
+        weight_t weight;
+    };
+
+    const weighted_edge no_weighted_edge{csr_graph::no_edge, 0};
+
+    /**
+     * @return The heavier of two edges, a if they weigh the same
+     */
+    inline weighted_edge heavier(weighted_edge a, weighted_edge b) {
+        return a.id == csr_graph::no_edge || (b.id != csr_graph::no_edge && b.weight > a.weight) ? b : a;
+    }
+
+    /**
+     * Disjoint sets of the finished vertices of Tarjan's LCA algorithm. A finished vertex is linked under its parent
+     * in the tree, so the root of a set is its topmost vertex, and every link keeps the heaviest tree edge
+     * between the vertex and the one it points to. Path compression folds these maxima along the compressed path.
+     */
+    class path_max_sets {
+        std::vector<vertex_id> m_parent;
+        std::vector<weighted_edge> m_heaviest;
+        std::vector<vertex_id> m_path{};
+
+    public:
+        explicit path_max_sets(std::size_t n) : m_parent(n), m_heaviest(n, no_weighted_edge) {
+            std::iota(m_parent.begin(), m_parent.end(), vertex_id{0});
+        }
+
+        inline void link(vertex_id child, vertex_id parent, weighted_edge e) {
+            m_parent[child] = parent;
+            m_heaviest[child] = e;
+        }
+
+        /**
+         * Finds the root of the set of x and points every vertex on the way directly to it
+         * @param heaviest Receives the heaviest tree edge between x and the root, no_edge if x is the root
+         * @return The root
+         */
+        vertex_id find(vertex_id x, weighted_edge &heaviest) {
+            m_path.clear();
+            while (m_parent[x] != x) {
+                m_path.push_back(x);
+                x = m_parent[x];
+            }
+
+            // from the top down, so the parent of every vertex already points to the root
+            for (auto i = m_path.size(); i-- > 0;) {
+                auto v = m_path[i], p = m_parent[v];
+                if (p == x) continue;
+
+                m_heaviest[v] = heavier(m_heaviest[v], m_heaviest[p]);
+                m_parent[v] = x;
+            }
+
+            heaviest = m_path.empty() ? no_weighted_edge : m_heaviest[m_path.front()];
+            return x;
+        }
+    };
+
+    /**
+     * Non-tree edge waiting at the lowest common ancestor of its endpoints. The path from the endpoint finished
+     * first is known when the edge is found, only the other one is looked up at the ancestor.
+     */
+    struct pending_edge {
+        edge_id id;
+        vertex_id endpoint;         // finished last
+        weight_t weight;
+        weighted_edge heaviest;     // on the path from the other endpoint to the ancestor
+        std::size_t next;           // next edge waiting at the same ancestor
+    };
+
+    const std::size_t no_pending = SIZE_MAX;
+
+    /**
+     * Adjacency of the tree edges, grouped by vertex like the adjacency of the graph
+     */
+    struct tree_adjacency {
+        std::vector<std::size_t> offsets;
+        std::vector<edge_id> slots;
+
+        tree_adjacency(csr_graph const &g, std::vector<edge_id> const &tree) : offsets(g.vertex_count() + 1, 0) {
+            auto vertex_count = g.vertex_count();
+            auto sources = g.sources();
+            auto targets = g.targets();
+
+            for (auto e : tree) {
+                ++offsets[sources[e] + 1];
+                ++offsets[targets[e] + 1];
+            }
+            for (std::size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+            slots.resize(offsets[vertex_count]);
+            std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+            for (auto e : tree) {
+                slots[next[sources[e]]++] = e;
+                slots[next[targets[e]]++] = e;
+            }
+        }
+    };
+
+    inline vertex_id other_end(csr_graph const &g, edge_id e, vertex_id v) {
+        return g.sources()[e] == v ? g.targets()[e] : g.sources()[e];
+    }
+
+    /**
+     * Finds the heaviest edge on the tree path between two vertices of the same tree by a search from one of them
+     */
+    edge_id heaviest_on_path(csr_graph const &g, tree_adjacency const &adjacency, vertex_id from, vertex_id to) {
+        std::vector<edge_id> parent_edge(g.vertex_count(), csr_graph::no_edge);
+        std::vector<vertex_id> queue{from};
+
+        for (std::size_t i = 0; i < queue.size() && queue[i] != to; i++) {
+            auto v = queue[i];
+            for (auto slot = adjacency.offsets[v]; slot < adjacency.offsets[v + 1]; slot++) {
+                auto e = adjacency.slots[slot];
+                auto u = other_end(g, e, v);
+
+                if (u != from && parent_edge[u] == csr_graph::no_edge) {
+                    parent_edge[u] = e;
+                    queue.push_back(u);
+                }
+            }
+        }
+
+        auto heaviest = no_weighted_edge;
+        for (auto v = to; v != from; v = other_end(g, parent_edge[v], v))
+            heaviest = heavier(heaviest, weighted_edge{parent_edge[v], g.weights()[parent_edge[v]]});
+
+        return heaviest.id;
+    }
+
+    /**
+     * Checks the cycle property in the order of csr_graph::lighter(), like Kruskal's algorithm with the tree
+     * instead of the cheapest edges: once the tree edges of a weight are joined, the union-find holds exactly
+     * the tree edges not heavier than it, so a non-tree edge of that weight violates the property if and only if
+     * its endpoints are still in different sets. Finds only the violating edge of the smallest id, no witnesses.
+     */
+    void check_in_weight_order(csr_graph const &g, std::vector<bool> const &in_tree, std::size_t components,
+                               thread_pool *pool, mst_verification &verdict) {
+        auto sources = g.sources();
+        auto targets = g.targets();
+        auto weights = g.weights();
+
+        arena scratch;
+        auto edges = sorted_edges(g, pool, scratch);
+        arena_union_find sets{g.vertex_count(), arena_allocator<union_find::id_t>(scratch)};
+
+        // once the whole tree is joined, the endpoints of every remaining edge are connected by lighter edges
+        for (std::size_t begin = 0; begin < edges.size() && sets.set_count() > components;) {
+            auto weight = weights[edges[begin]];
+            auto end = begin;
+            while (end < edges.size() && weights[edges[end]] == weight) ++end;
+
+            for (auto i = begin; i < end; i++)
+                if (in_tree[edges[i]]) sets.unite(sources[edges[i]], targets[edges[i]]);
+
+            for (auto i = begin; i < end; i++) {
+                auto e = edges[i];
+                if (in_tree[e] || sets.find(sources[e]) == sets.find(targets[e])) continue;
+
+                if (verdict.valid || e < verdict.violating) {
+                    verdict.valid = false;
+                    verdict.violating = e;
+                }
+                // the edges of a weight are sorted by id
+                break;
+            }
+
+            begin = end;
+        }
+    }
+
+    /**
+     * Checks the cycle property with Tarjan's offline LCA algorithm, finding the heaviest tree edge on the cycle
+     * of every non-tree edge (see verify_mst())
+     */
+    void check_with_witnesses(csr_graph const &g, tree_adjacency const &adjacency, std::vector<bool> const &in_tree,
+                              std::vector<edge_id> &witnesses, mst_verification &verdict) {
+        auto vertex_count = g.vertex_count();
+        auto edge_count = g.edge_count();
+        auto weights = g.weights();
+        auto offsets = g.offsets();
+        auto neighbors = g.neighbors();
+        auto neighbor_edges = g.neighbor_edges();
+        auto neighbor_weights = g.neighbor_weights();
+
+        // non-tree edges waiting at every vertex, as linked lists
+        std::vector<std::size_t> waiting(vertex_count, no_pending);
+        std::vector<pending_edge> pending;
+        pending.reserve(edge_count - (adjacency.slots.size() / 2));
+
+        std::vector<std::uint8_t> state(vertex_count, unvisited);
+        std::vector<edge_id> parent_edge(vertex_count, csr_graph::no_edge);
+        std::vector<std::pair<vertex_id, std::size_t>> stack;
+        path_max_sets paths{vertex_count};
+
+        for (vertex_id root = 0; root < vertex_count; root++) {
+            if (state[root] != unvisited) continue;
+
+            state[root] = open;
+            stack.emplace_back(root, adjacency.offsets[root]);
+
+            while (!stack.empty()) {
+                auto v = stack.back().first;
+                auto &slot = stack.back().second;
+
+                if (slot < adjacency.offsets[v + 1]) {
+                    auto e = adjacency.slots[slot++];
+                    auto u = other_end(g, e, v);
+
+                    if (state[u] == unvisited) {
+                        state[u] = open;
+                        parent_edge[u] = e;
+                        stack.emplace_back(u, adjacency.offsets[u]);
+                    }
+                    continue;
+                }
+
+                // every non-tree edge is queued by the endpoint finished last: the set of the other endpoint
+                // is rooted at the lowest vertex still open above it, which is the common ancestor
+                for (auto s = offsets[v]; s < offsets[v + 1]; s++) {
+                    auto e = neighbor_edges[s];
+                    if (state[neighbors[s]] != finished || in_tree[e]) continue;
+
+                    weighted_edge heaviest;
+                    auto lca = paths.find(neighbors[s], heaviest);
+
+                    pending.push_back(pending_edge{e, v, neighbor_weights[s], heaviest, waiting[lca]});
+                    waiting[lca] = pending.size() - 1;
+                }
+
+                state[v] = finished;
+
+                // all descendants of v are in its set now, so the other path of every edge waiting here is known
+                for (auto i = waiting[v]; i != no_pending; i = pending[i].next) {
+                    auto const &p = pending[i];
+
+                    weighted_edge heaviest;
+                    paths.find(p.endpoint, heaviest);
+                    heaviest = heavier(p.heaviest, heaviest);
+                    witnesses[p.id] = heaviest.id;
+
+                    if (p.weight < heaviest.weight && (verdict.valid || p.id < verdict.violating)) {
+                        verdict.valid = false;
+                        verdict.violating = p.id;
+                        verdict.replaced = heaviest.id;
+                    }
+                }
+
+                if (parent_edge[v] != csr_graph::no_edge) {
+                    auto e = parent_edge[v];
+                    paths.link(v, other_end(g, e, v), weighted_edge{e, weights[e]});
+                }
+                stack.pop_back();
+            }
+        }
+    }
+}
+
+mst_verification verify_mst(csr_graph const &g, std::vector<edge_id> const &tree, thread_pool *pool,
+                            std::vector<edge_id> *witnesses) {
+    auto vertex_count = g.vertex_count();
+    auto edge_count = g.edge_count();
+    auto sources = g.sources();
+    auto targets = g.targets();
+
+    if (witnesses != nullptr) witnesses->assign(edge_count, csr_graph::no_edge);
+
+    std::vector<bool> in_tree(edge_count, false);
+    union_find sets{vertex_count};
+
+    for (auto e : tree) {
+        if (e >= edge_count) return invalid("The tree refers to edge " + std::to_string(e) + " of " +
+                                            std::to_string(edge_count) + " edges");
+        if (in_tree[e]) return invalid("The tree contains the edge " + describe(g, e) + " twice");
+        if (!sets.unite(sources[e], targets[e])) return invalid("The tree edge " + describe(g, e) + " closes a cycle");
+
+        in_tree[e] = true;
+    }
+
+    // an acyclic subgraph has an edge less than vertices per component, so it spans the graph
+    // if and only if it has as many components
+    auto components = connected_components(g, pool).count;
+    if (tree.size() + components != vertex_count)
+        return invalid("The tree has " + std::to_string(tree.size()) + " edges, a spanning forest of the graph needs " +
+                       std::to_string(vertex_count - components));
+
+    mst_verification verdict{};
+
+    if (witnesses != nullptr) {
+        check_with_witnesses(g, tree_adjacency{g, tree}, in_tree, *witnesses, verdict);
+    } else {
+        check_in_weight_order(g, in_tree, components, pool, verdict);
+
+        if (!verdict.valid)
+            verdict.replaced = heaviest_on_path(g, tree_adjacency{g, tree}, sources[verdict.violating],
+                                                targets[verdict.violating]);
+    }
+
+    if (!verdict.valid)
+        verdict.problem = "The edge " + describe(g, verdict.violating) + " is lighter than the tree edge " +
+                          describe(g, verdict.replaced) + " on the cycle it closes";
+
+    return verdict;
+}
+
+mst_verification verify_mst(csr_graph const &g, std::vector<edge> const &tree, thread_pool *pool,
+                            std::vector<edge_id> *witnesses) {
+    std::vector<edge_id> ids;
+    ids.reserve(tree.size());
+
+    for (auto const &x : tree) {
+        auto a = g.find_vertex(x.start), b = g.find_vertex(x.end);
+        auto e = a < g.vertex_count() && b < g.vertex_count() ? g.find_edge(a, b) : csr_graph::no_edge;
+
+        if (e == csr_graph::no_edge || g.weights()[e] != x.weight)
+            return invalid("The tree edge (" + std::to_string(x.start) + ", " + std::to_string(x.end) + ", " +
+                           std::to_string(x.weight) + ") is not a part of the graph");
+
+        ids.push_back(e);
+    }
+
+    return verify_mst(g, ids, pool, witnesses);
+}
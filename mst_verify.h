@@ -0,0 +1,62 @@
+#ifndef MINIMUM_SPANNING_TREE_MST_VERIFY_H
+#define MINIMUM_SPANNING_TREE_MST_VERIFY_H
+
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+#include "edge.h"
+
+class thread_pool;
+
+/**
+ * Outcome of verify_mst()
+ */
+struct mst_verification {
+    bool valid{true};
+    std::string problem{};                                  // why the tree is not a minimum spanning forest
+    csr_graph::edge_id violating{csr_graph::no_edge};       // non-tree edge lighter than a tree edge on its cycle
+    csr_graph::edge_id replaced{csr_graph::no_edge};        // heaviest tree edge on the cycle of the violating edge
+};
+
+/**
+ * Checks that the tree is a minimum spanning forest of the graph.
+ *
+ * The tree has to be a forest (no edge twice, no cycle) with an edge less than vertices per component of the
+ * graph, found by connected_components(). It is minimal if and only if no non-tree edge is lighter than the
+ * heaviest tree edge on the path between its endpoints (the cycle property; equal weights are fine, so every
+ * one of several minimum spanning forests passes).
+ *
+ * Without witnesses, the edges are scanned in the order of csr_graph::lighter() (the parallel radix sort of
+ * Kruskal's algorithm) while a union-find joins the tree edges weight by weight: a non-tree edge violates the
+ * property if and only if the tree edges not heavier than it leave its endpoints apart. The scan stops once
+ * the whole tree is joined, and only the reported violation needs a search of the tree path.
+ *
+ * With witnesses, the path maxima are answered offline with Tarjan's LCA algorithm instead: the tree is walked
+ * depth-first without recursion, every finished vertex is linked under its parent in a union-find which keeps
+ * the heaviest tree edge between every vertex and its set root, and every non-tree edge is checked at the lowest
+ * common ancestor of its endpoints, when both paths to it are in one set.
+ *
+ * Both are close to linear in practice, with O(V + E) memory and no second MST computation.
+ * @param g CSR graph
+ * @param tree Ids of the tree edges
+ * @param pool Pool finding the components, nullptr runs everything in the calling thread
+ * @param witnesses If not null, receives for every edge id the heaviest tree edge on the cycle the edge closes,
+ *                  csr_graph::no_edge for the tree edges; with the tree, this is a certificate of minimality
+ *                  which can be checked edge by edge
+ * @return The verdict, with the non-tree edge of the smallest id that violates the cycle property if any
+ */
+mst_verification verify_mst(csr_graph const &g, std::vector<csr_graph::edge_id> const &tree, thread_pool *pool,
+                            std::vector<csr_graph::edge_id> *witnesses = nullptr);
+
+/**
+ * Finds the edges of a tree loaded from a file (see load_result()) in the graph and verifies it
+ * @param g CSR graph
+ * @param tree Tree edges with the original vertex labels
+ * @param pool Pool finding the components, nullptr runs everything in the calling thread
+ * @param witnesses See verify_mst()
+ * @return The verdict, invalid as well if an edge is not a part of the graph or has another weight there
+ */
+mst_verification verify_mst(csr_graph const &g, std::vector<edge> const &tree, thread_pool *pool,
+                            std::vector<csr_graph::edge_id> *witnesses = nullptr);
+
+#endif //MINIMUM_SPANNING_TREE_MST_VERIFY_H
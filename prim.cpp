@@ -0,0 +1,45 @@
+#include "mst_engine.h"
+#include <utility>
+#include "arena.h"
+#include "dary_heap.h"
+
+edge_ids_t prim_mst::run(csr_graph const &g, thread_pool *, arena &scratch) const {
+    typedef std::pair<weight_t, csr_graph::edge_id> heap_key; // (weight, id) matches csr_graph::lighter()
+
+    auto vertex_count = g.vertex_count();
+    auto offsets = g.offsets();
+    auto neighbors = g.neighbors();
+    auto neighbor_weights = g.neighbor_weights();
+    auto neighbor_edges = g.neighbor_edges();
+
+    edge_ids_t tree;
+    if (vertex_count == 0) return tree;
+
+    tree.reserve(vertex_count - 1);
+
+    arena_vector<bool> in_tree(vertex_count, false, arena_allocator<bool>(scratch));
+    dary_heap<4, heap_key, arena_allocator<heap_key>> heap{vertex_count, arena_allocator<heap_key>(scratch)};
+
+    // every vertex left unreached by the previous trees roots the tree of another component
+    for (csr_graph::vertex_id root = 0; root < vertex_count; root++) {
+        if (in_tree[root]) continue;
+
+        heap.push_or_decrease(root, heap_key{0, csr_graph::no_edge});
+
+        while (!heap.empty()) {
+            auto v = heap.pop();
+            auto e = heap.key(v).second;
+
+            in_tree[v] = true;
+            if (e != csr_graph::no_edge) tree.push_back(e);
+
+            // offers every edge to a vertex outside of the tree as its new cheapest connection
+            for (auto slot = offsets[v]; slot < offsets[v + 1]; slot++) {
+                auto u = neighbors[slot];
+                if (!in_tree[u]) heap.push_or_decrease(u, heap_key{neighbor_weights[slot], neighbor_edges[slot]});
+            }
+        }
+    }
+
+    return tree;
+}
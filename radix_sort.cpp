@@ -0,0 +1,103 @@
+#include "radix_sort.h"
+#include <algorithm>
+#include <array>
+#include <utility>
+#include "thread_pool.h"
+
+namespace {
+    const unsigned digit_bits = 8;
+    const std::size_t digit_count = std::size_t{1} << digit_bits;
+
+    /**
+     * Blocks shorter than this are not worth a separate task
+     */
+    const std::size_t min_block_size = 1 << 16;
+}
+
+void radix_sort_edges(csr_graph const &g, csr_graph::edge_id *ids, std::size_t n, thread_pool *pool, arena &scratch) {
+    if (n < 2) return;
+
+    auto weights = g.weights();
+
+    auto block_count = pool == nullptr ? 1 : std::max<std::size_t>(1, std::min(n / min_block_size, 4 * pool->size()));
+    auto block_length = (n + block_count - 1) / block_count;
+
+    // the keys are gathered once, so the passes stream through memory instead of looking weights up by id
+    auto keys = scratch.allocate_array<weight_t>(n);
+    auto key_buffer = scratch.allocate_array<weight_t>(n);
+    auto id_buffer = scratch.allocate_array<csr_graph::edge_id>(n);
+    auto block_max = scratch.allocate_array<weight_t>(block_count);
+    auto sorted = ids;
+
+    for_each_task(pool, block_count, [&](std::size_t block) {
+        auto end = std::min(n, (block + 1) * block_length);
+        weight_t max = 0;
+
+        for (auto i = block * block_length; i < end; i++) {
+            keys[i] = weights[sorted[i]];
+            max = std::max(max, keys[i]);
+        }
+
+        block_max[block] = max;
+    });
+
+    auto max_key = *std::max_element(block_max, block_max + block_count);
+
+    auto offsets = scratch.allocate_array<std::array<std::size_t, digit_count>>(block_count);
+
+    for (unsigned shift = 0; shift < 8 * sizeof(weight_t) && (max_key >> shift) != 0; shift += digit_bits) {
+        for_each_task(pool, block_count, [&](std::size_t block) {
+            auto &counts = offsets[block];
+            counts.fill(0);
+
+            auto end = std::min(n, (block + 1) * block_length);
+            for (auto i = block * block_length; i < end; i++) ++counts[(keys[i] >> shift) & (digit_count - 1)];
+        });
+
+        // when all keys share this digit, the pass would not move anything
+        auto shared_digit = false;
+        for (std::size_t digit = 0; digit < digit_count && !shared_digit; digit++) {
+            std::size_t digit_total = 0;
+            for (std::size_t block = 0; block < block_count; block++) digit_total += offsets[block][digit];
+
+            shared_digit = digit_total == n;
+        }
+        if (shared_digit) continue;
+
+        // exclusive prefix sum over (digit, block), so equal digits keep the block order and the sort is stable
+        std::size_t running = 0;
+        for (std::size_t digit = 0; digit < digit_count; digit++) {
+            for (std::size_t block = 0; block < block_count; block++) {
+                auto count = offsets[block][digit];
+                offsets[block][digit] = running;
+                running += count;
+            }
+        }
+
+        for_each_task(pool, block_count, [&](std::size_t block) {
+            auto &next = offsets[block];
+
+            auto end = std::min(n, (block + 1) * block_length);
+            for (auto i = block * block_length; i < end; i++) {
+                auto position = next[(keys[i] >> shift) & (digit_count - 1)]++;
+                key_buffer[position] = keys[i];
+                id_buffer[position] = sorted[i];
+            }
+        });
+
+        std::swap(keys, key_buffer);
+        std::swap(sorted, id_buffer);
+    }
+
+    // after an odd number of passes the result is in the buffer
+    if (sorted != ids) std::copy(sorted, sorted + n, ids);
+}
+
+arena_vector<csr_graph::edge_id> sorted_edges(csr_graph const &g, thread_pool *pool, arena &scratch) {
+    arena_vector<csr_graph::edge_id> ids(g.edge_count(), arena_allocator<csr_graph::edge_id>(scratch));
+    for (std::size_t e = 0; e < ids.size(); e++) ids[e] = static_cast<csr_graph::edge_id>(e);
+
+    radix_sort_edges(g, ids.data(), ids.size(), pool, scratch);
+
+    return ids;
+}
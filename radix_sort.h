@@ -0,0 +1,33 @@
+#ifndef MINIMUM_SPANNING_TREE_RADIX_SORT_H
+#define MINIMUM_SPANNING_TREE_RADIX_SORT_H
+
+#include "arena.h"
+#include "csr_graph.h"
+
+class thread_pool;
+
+/**
+ * Sorts edge ids by weight with a parallel least-significant-digit radix sort (8-bit digits).
+ *
+ * The input is split into one block per task; every pass builds per-block digit histograms, turns them into
+ * scatter offsets and scatters the blocks independently. Only as many passes run as the largest weight
+ * has bytes, and passes in which all weights share the digit are skipped.
+ * The sort is stable, so ids sorted ascending on input come out in csr_graph::lighter() order.
+ * @param g Graph the edges belong to
+ * @param ids Edge ids to sort in place
+ * @param n Number of ids
+ * @param pool Pool for the histogram and scatter phases, nullptr sorts in the calling thread
+ * @param scratch Arena for the keys and the scatter buffers
+ */
+void radix_sort_edges(csr_graph const &g, csr_graph::edge_id *ids, std::size_t n, thread_pool *pool, arena &scratch);
+
+/**
+ * Returns the ids of all edges of a graph in csr_graph::lighter() order
+ * @param g Graph
+ * @param pool Pool used by the sort, nullptr sorts in the calling thread
+ * @param scratch Arena for the ids and the buffers of the sort
+ * @return Sorted edge ids
+ */
+arena_vector<csr_graph::edge_id> sorted_edges(csr_graph const &g, thread_pool *pool, arena &scratch);
+
+#endif //MINIMUM_SPANNING_TREE_RADIX_SORT_H
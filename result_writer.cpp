@@ -0,0 +1,284 @@
+#include "result_writer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include "graph_file.h"
+#include "line_parser.h"
+#include "mapped_file.h"
+
+namespace {
+    const char result_magic[8] = {'M', 'S', 'T', 'E', 'D', 'G', 'E', 'S'};
+    const std::uint32_t result_version = 1;
+    const std::uint64_t byte_order_mark = 0x0102030405060708ULL;
+
+    /**
+     * Text formatted before it is passed to the file
+     */
+    const std::size_t text_block_size = 1 << 20;
+
+    inline void append_number(std::string &out, std::uint64_t value) {
+        char digits[20];
+        int length = 0;
+
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        while (length > 0) out.push_back(digits[--length]);
+    }
+
+    /**
+     * Endpoints of an edge as dense ids, the smaller one first. Labels are sorted like the ids,
+     * so the order of the pairs is the order of the original labels.
+     */
+    inline std::pair<csr_graph::vertex_id, csr_graph::vertex_id> endpoints(csr_graph const &g, csr_graph::edge_id e) {
+        auto a = g.sources()[e], b = g.targets()[e];
+        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+
+    binary_result_header make_header(csr_graph const &g, std::size_t edge_count, unsigned long long total_weight) {
+        binary_result_header header{};
+        std::memcpy(header.magic, result_magic, sizeof(result_magic));
+        header.version = result_version;
+        header.header_size = sizeof(binary_result_header);
+        header.byte_order = byte_order_mark;
+        header.vertex_count = g.vertex_count();
+        header.edge_count = edge_count;
+        header.total_weight = total_weight;
+
+        return header;
+    }
+}
+
+bool parse_result_format(std::string const &name, result_format &format) {
+    if (name == "adjacency") format = result_format::adjacency;
+    else if (name == "edges") format = result_format::edge_list;
+    else if (name == "binary") format = result_format::binary;
+    else return false;
+
+    return true;
+}
+
+result_writer::result_writer(csr_graph const &g, std::string filename, result_format format, bool streaming)
+        : m_graph{g}, m_filename{std::move(filename)}, m_format{format}, m_streaming{streaming},
+          m_buffer(1 << 20) {
+    if (streaming && format == result_format::adjacency)
+        throw std::invalid_argument("The adjacency format cannot be streamed, use the edge list or binary format");
+
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_file.open(m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file) throw std::runtime_error("Cannot open " + m_filename + " for writing");
+
+    m_text.reserve(text_block_size + 256);
+
+    // the counts are known only at the end, so the header is written twice
+    if (format == result_format::binary) {
+        auto header = make_header(g, 0, 0);
+        m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    }
+}
+
+void result_writer::add(csr_graph::edge_id const *edges, std::size_t count) {
+    auto weights = m_graph.weights();
+
+    m_edge_count += count;
+    for (std::size_t i = 0; i < count; i++) m_total_weight += weights[edges[i]];
+
+    if (m_streaming) {
+        write_edges(edges, count);
+    } else {
+        m_edges.insert(m_edges.end(), edges, edges + count);
+    }
+}
+
+void result_writer::write_edges(csr_graph::edge_id const *edges, std::size_t count) {
+    auto weights = m_graph.weights();
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto ends = endpoints(m_graph, edges[i]);
+
+        if (m_format == result_format::binary) {
+            binary_result_edge record{m_graph.label(ends.first), m_graph.label(ends.second), weights[edges[i]]};
+            m_text.append(reinterpret_cast<char const *>(&record), sizeof(record));
+        } else {
+            append_number(m_text, m_graph.label(ends.first));
+            m_text.push_back(' ');
+            append_number(m_text, m_graph.label(ends.second));
+            m_text.push_back(' ');
+            append_number(m_text, weights[edges[i]]);
+            m_text.push_back('\n');
+        }
+
+        drain(text_block_size);
+    }
+}
+
+void result_writer::write_adjacency() {
+    auto vertex_count = m_graph.vertex_count();
+    auto sources = m_graph.sources();
+    auto targets = m_graph.targets();
+    auto weights = m_graph.weights();
+
+    // groups both directions of every edge by vertex like the CSR adjacency, the edges are sorted by id
+    // before, so the lines do not depend on the order the engine found the edges in
+    std::sort(m_edges.begin(), m_edges.end());
+
+    std::vector<std::size_t> offsets(vertex_count + 1, 0);
+    for (auto e : m_edges) {
+        ++offsets[sources[e] + 1];
+        ++offsets[targets[e] + 1];
+    }
+    for (std::size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+    std::vector<csr_graph::edge_id> slots(offsets[vertex_count]);
+    std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+    for (auto e : m_edges) {
+        slots[next[sources[e]]++] = e;
+        slots[next[targets[e]]++] = e;
+    }
+
+    append_number(m_text, vertex_count);
+    m_text.push_back(' ');
+    append_number(m_text, m_edges.size());
+    m_text.push_back('\n');
+
+    for (std::size_t v = 0; v < vertex_count; v++) {
+        append_number(m_text, m_graph.label(static_cast<csr_graph::vertex_id>(v)));
+        m_text.push_back(' ');
+        append_number(m_text, offsets[v + 1] - offsets[v]);
+
+        for (auto slot = offsets[v]; slot < offsets[v + 1]; slot++) {
+            auto e = slots[slot];
+
+            m_text.push_back(' ');
+            append_number(m_text, m_graph.label(sources[e] == v ? targets[e] : sources[e]));
+            m_text.push_back(' ');
+            append_number(m_text, weights[e]);
+        }
+
+        m_text.push_back('\n');
+        drain(text_block_size);
+    }
+}
+
+void result_writer::drain(std::size_t limit) {
+    if (m_text.size() < limit) return;
+
+    m_file.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+    m_text.clear();
+
+    if (!m_file) throw std::runtime_error("Cannot write " + m_filename);
+}
+
+void result_writer::finish() {
+    if (m_format == result_format::adjacency) {
+        write_adjacency();
+    } else if (!m_streaming) {
+        std::sort(m_edges.begin(), m_edges.end(), [this](csr_graph::edge_id a, csr_graph::edge_id b) {
+            return endpoints(m_graph, a) < endpoints(m_graph, b);
+        });
+        write_edges(m_edges.data(), m_edges.size());
+    }
+
+    drain(0);
+    std::vector<csr_graph::edge_id>().swap(m_edges);
+
+    if (m_format == result_format::binary) {
+        auto header = make_header(m_graph, m_edge_count, m_total_weight);
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    }
+
+    if (!m_file.flush()) throw std::runtime_error("Cannot write " + m_filename);
+}
+
+void write_result(csr_graph const &g, std::vector<csr_graph::edge_id> const &tree, std::string const &filename,
+                  result_format format) {
+    result_writer writer{g, filename, format, false};
+    writer.add(tree.data(), tree.size());
+    writer.finish();
+}
+
+std::vector<edge> load_result(std::string const &filename) {
+    mapped_file file{filename};
+    file.advise_sequential();
+
+    auto data = file.data(), end = data + file.size();
+    std::vector<edge> edges;
+
+    if (file.size() >= sizeof(result_magic) && std::memcmp(data, result_magic, sizeof(result_magic)) == 0) {
+        binary_result_header header{};
+        if (file.size() < sizeof(header)) throw std::runtime_error(filename + " is corrupted (wrong size)");
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.version != result_version || header.header_size != sizeof(header))
+            throw std::runtime_error(filename + " has unsupported version " + std::to_string(header.version));
+        if (header.byte_order != byte_order_mark)
+            throw std::runtime_error(filename + " was written on a machine with a different byte order");
+        if (file.size() != sizeof(header) + header.edge_count * sizeof(binary_result_edge))
+            throw std::runtime_error(filename + " is corrupted (wrong size)");
+
+        edges.reserve(header.edge_count);
+        for (std::size_t i = 0; i < header.edge_count; i++) {
+            binary_result_edge record{};
+            std::memcpy(&record, data + sizeof(header) + i * sizeof(record), sizeof(record));
+            edges.emplace_back(record.start, record.end, record.weight);
+        }
+
+        return edges;
+    }
+
+    std::size_t line_number = 0;
+    auto first = true, adjacency = false;
+
+    while (data < end) {
+        auto line_end = static_cast<char const *>(std::memchr(data, '\n', static_cast<std::size_t>(end - data)));
+        if (line_end == nullptr) line_end = end;
+        ++line_number;
+
+        line_parser line{data, line_end};
+        data = line_end + 1;
+
+        if (line.at_end()) continue;
+
+        std::uint64_t start, second, target, weight;
+
+        // the header of the adjacency format is the only line with two numbers
+        if (first) {
+            first = false;
+
+            line_parser probe = line;
+            if (probe.read(start) && probe.read(second) && probe.at_end()) {
+                adjacency = true;
+                edges.reserve(second);
+                continue;
+            }
+        }
+
+        if (!adjacency) {
+            if (!line.read(start) || !line.read(target) || !line.read(weight) || !line.at_end())
+                throw parse_error(filename, line_number, "expected <start> <end> <weight>");
+
+            edges.emplace_back(start, target, weight);
+            continue;
+        }
+
+        if (!line.read(start) || !line.read(second))
+            throw parse_error(filename, line_number, "expected <vertex> <number of edges>");
+
+        // every edge is listed by both of its endpoints, only the line of the smaller one keeps it
+        for (std::uint64_t i = 0; i < second; i++) {
+            if (!line.read(target) || !line.read(weight))
+                throw parse_error(filename, line_number, "expected <target vertex> <weight> of edge " +
+                                                         std::to_string(i + 1) + " of " + std::to_string(second));
+
+            if (start < target) edges.emplace_back(start, target, weight);
+        }
+
+        if (!line.at_end()) throw parse_error(filename, line_number, "more than " + std::to_string(second) + " edges");
+    }
+
+    return edges;
+}
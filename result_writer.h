@@ -0,0 +1,139 @@
+#ifndef MINIMUM_SPANNING_TREE_RESULT_WRITER_H
+#define MINIMUM_SPANNING_TREE_RESULT_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+#include "edge.h"
+
+/**
+ * Formats of the MST output
+ */
+enum class result_format {
+    adjacency,  // the text graph format of the input files, one line per vertex
+    edge_list,  // one "<start> <end> <weight>" line per edge
+    binary      // binary_result_header followed by one binary_result_edge per edge
+};
+
+/**
+ * @param name Format name: adjacency, edges or binary
+ * @param format Receives the format
+ * @return False if the name is unknown
+ */
+bool parse_result_format(std::string const &name, result_format &format);
+
+/**
+ * Header of a binary MST file, version 1. Numbers are stored in the native byte order, which the header records.
+ */
+struct binary_result_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t byte_order;
+    std::uint64_t vertex_count;
+    std::uint64_t edge_count;
+    std::uint64_t total_weight;
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(binary_result_header) == 64, "The binary result header must be 64 bytes long");
+
+/**
+ * Edge of a binary MST file, with the original vertex labels and the smaller one first
+ */
+struct binary_result_edge {
+    std::uint64_t start;
+    std::uint64_t end;
+    std::uint64_t weight;
+};
+
+/**
+ * Buffered writer of the edges of an MST (or a spanning forest) of a CSR graph.
+ *
+ * Numbers are formatted by hand into a text buffer which is written to the file in large blocks, there is
+ * no flush until finish(). The adjacency format groups the edges by vertex, so they are collected and written
+ * by finish(). The edge list and binary formats are written sorted by (start, end) as well, unless the writer
+ * streams: then every batch passed to add() is written right away in the order it comes.
+ */
+class result_writer {
+    csr_graph const &m_graph;
+    std::string m_filename;
+    result_format m_format;
+    bool m_streaming;
+    std::vector<char> m_buffer;
+    std::ofstream m_file{};
+    std::string m_text{};
+    std::vector<csr_graph::edge_id> m_edges{};
+    std::size_t m_edge_count{0};
+    unsigned long long m_total_weight{0};
+
+    /**
+     * Writes edges in the edge list or binary format
+     */
+    void write_edges(csr_graph::edge_id const *edges, std::size_t count);
+
+    /**
+     * Writes the collected edges in the adjacency format, with a line for every vertex of the graph
+     */
+    void write_adjacency();
+
+    /**
+     * Writes the text buffer to the file once it is larger than the limit
+     */
+    void drain(std::size_t limit);
+
+public:
+    /**
+     * Opens the file, its previous content is lost
+     * @param g Graph the edge ids belong to, it has to outlive the writer
+     * @param filename Path to the file
+     * @param format Output format
+     * @param streaming True to write every batch as soon as add() receives it
+     * @throws std::invalid_argument if a writer in the adjacency format is asked to stream
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    result_writer(csr_graph const &g, std::string filename, result_format format, bool streaming);
+
+    /**
+     * Adds MST edges, the same edge must not be added twice
+     * @param edges Edge ids
+     * @param count Number of the edges
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void add(csr_graph::edge_id const *edges, std::size_t count);
+
+    /**
+     * Writes the collected edges and flushes the file
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void finish();
+
+    inline std::size_t edge_count() const { return m_edge_count; }
+    inline unsigned long long total_weight() const { return m_total_weight; }
+};
+
+/**
+ * Writes the edges of an MST to a file at once, see result_writer
+ * @param g Graph the edge ids belong to
+ * @param tree Ids of the MST edges
+ * @param filename Path to the file
+ * @param format Output format
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_result(csr_graph const &g, std::vector<csr_graph::edge_id> const &tree, std::string const &filename,
+                  result_format format);
+
+/**
+ * Loads the edges of an MST file in any of the formats of result_writer. Binary files are recognized by their
+ * magic, text files by the first line: two numbers start the adjacency format, three an edge list.
+ * @param filename Path to the file
+ * @return The edges with the original vertex labels, every edge once
+ * @throws parse_error for the first malformed line of a text file
+ * @throws std::runtime_error if the file cannot be read or a binary file is corrupted
+ */
+std::vector<edge> load_result(std::string const &filename);
+
+#endif //MINIMUM_SPANNING_TREE_RESULT_WRITER_H
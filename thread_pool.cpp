@@ -0,0 +1,168 @@
+#include "thread_pool.h"
+
+namespace {
+    thread_local thread_pool const *current_pool = nullptr;
+    thread_local std::size_t current_index = 0;
+    thread_local bool in_task = false;
+
+    std::atomic<std::size_t> global_thread_count{0};
+}
+
+thread_pool::thread_pool(std::size_t thread_count) {
+    if (thread_count == 0) thread_count = default_thread_count();
+
+    for (std::size_t i = 0; i < thread_count; i++) m_queues.push_back(std::make_unique<task_queue>());
+    m_activity.reset(new activity_counter[thread_count + 1]);
+
+    m_threads.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; i++) m_threads.emplace_back([this, i]() { worker_loop(i); });
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto &thread : m_threads) thread.join();
+}
+
+std::size_t thread_pool::default_thread_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+thread_pool &thread_pool::global() {
+    static thread_pool pool{global_thread_count.load()};
+    return pool;
+}
+
+std::vector<worker_activity> thread_pool::activity() const {
+    std::vector<worker_activity> result(m_queues.size() + 1);
+
+    for (std::size_t i = 0; i < result.size(); i++)
+        result[i] = worker_activity{m_activity[i].tasks.load(), m_activity[i].busy_ns.load()};
+
+    return result;
+}
+
+void thread_pool::execute(task_t &task) {
+    auto nested = in_task;
+
+    if (m_recordings.load(std::memory_order_relaxed) == 0) {
+        in_task = true;
+        task();
+        in_task = nested;
+        return;
+    }
+
+    auto &counter = m_activity[current_pool == this ? current_index : m_queues.size()];
+    auto started = std::chrono::steady_clock::now();
+
+    in_task = true;
+    task();
+    in_task = nested;
+
+    // a task run while its thread waits inside another task is already part of the outer one's time
+    counter.tasks.fetch_add(1, std::memory_order_relaxed);
+    if (!nested) {
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+        counter.busy_ns.fetch_add(static_cast<std::uint64_t>(busy.count()), std::memory_order_relaxed);
+    }
+}
+
+void thread_pool::record_inline(std::chrono::steady_clock::time_point started) {
+    if (in_task) return;
+
+    auto &counter = m_activity[current_pool == this ? current_index : m_queues.size()];
+    auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+    counter.busy_ns.fetch_add(static_cast<std::uint64_t>(busy.count()), std::memory_order_relaxed);
+}
+
+void thread_pool::set_global_thread_count(std::size_t thread_count) {
+    global_thread_count = thread_count;
+}
+
+void thread_pool::submit(task_t task) {
+    static std::atomic<std::size_t> next_queue{0};
+
+    auto index = current_pool == this ? current_index : next_queue.fetch_add(1) % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+
+    m_pending.fetch_add(1);
+
+    // taking the lock orders the increment before the predicate check of a worker going to sleep
+    { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+    m_wake.notify_one();
+}
+
+bool thread_pool::try_pop(task_t &task) {
+    auto own = current_pool == this;
+    auto count = m_queues.size();
+
+    if (own) {
+        auto &queue = *m_queues[current_index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // steal the oldest task, which for split ranges is also the largest one
+    auto start = own ? current_index + 1 : 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto &queue = *m_queues[(start + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void thread_pool::worker_loop(std::size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    task_t task;
+
+    while (true) {
+        if (try_pop(task)) {
+            execute(task);
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this]() { return m_stop || m_pending > 0; });
+
+        if (m_stop) return;
+    }
+}
+
+void thread_pool::help_while(std::atomic<std::size_t> const &remaining) {
+    task_t task;
+
+    while (remaining.load() > 0) {
+        if (try_pop(task)) {
+            execute(task);
+            task = nullptr;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,230 @@
+#ifndef MINIMUM_SPANNING_TREE_THREAD_POOL_H
+#define MINIMUM_SPANNING_TREE_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work done by one thread of a pool, see thread_pool::activity()
+ */
+struct worker_activity {
+    std::uint64_t tasks;
+    std::uint64_t busy_ns;
+};
+
+/**
+ * Fixed-size pool of worker threads with one task deque per worker.
+ *
+ * A worker pushes and pops tasks at the back of its own deque and, when it runs dry, steals from the front
+ * of the other deques, so large ranges split by one worker get spread over the idle ones.
+ * Threads which wait for their tasks (including threads outside of the pool) keep executing queued tasks
+ * in the meantime, so parallel_for may be nested without deadlocking.
+ */
+class thread_pool {
+    typedef std::function<void()> task_t;
+
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    struct activity_counter {
+        std::atomic<std::uint64_t> tasks{0};
+        std::atomic<std::uint64_t> busy_ns{0};
+    };
+
+    std::vector<std::unique_ptr<task_queue>> m_queues;
+    std::unique_ptr<activity_counter[]> m_activity;
+    std::atomic<std::size_t> m_recordings{0};
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<bool> m_stop{false};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+
+    void worker_loop(std::size_t index);
+
+    /**
+     * Pops a task from the deque of the calling worker or steals one from another deque
+     * @param task Receives the task
+     * @return True if a task was found
+     */
+    bool try_pop(task_t &task);
+
+    /**
+     * Keeps executing queued tasks until the counter drops to zero
+     */
+    void help_while(std::atomic<std::size_t> const &remaining);
+
+    /**
+     * Runs a task and, while the activity is recorded, adds it to the activity of the calling thread
+     */
+    void execute(task_t &task);
+
+    /**
+     * Adds time spent on the work of the pool outside of a task to the activity of the calling thread
+     * @param started When the work started
+     */
+    void record_inline(std::chrono::steady_clock::time_point started);
+
+    /**
+     * Splits [begin, end) in halves until it is at most grain long, queueing the right halves as new tasks
+     * and running the leftmost chunk in the calling thread.
+     */
+    template<typename Body>
+    void split_range(std::size_t begin, std::size_t end, std::size_t grain, Body const &body,
+                     std::atomic<std::size_t> &remaining, std::exception_ptr &error, std::mutex &error_mutex) {
+        while (end - begin > grain) {
+            auto middle = begin + (end - begin) / 2;
+
+            remaining.fetch_add(1);
+            submit([this, middle, end, grain, &body, &remaining, &error, &error_mutex]() {
+                split_range(middle, end, grain, body, remaining, error, error_mutex);
+            });
+
+            end = middle;
+        }
+
+        try {
+            body(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+
+        remaining.fetch_sub(1);
+    }
+
+public:
+    /**
+     * Records the activity of a pool while it exists, see activity(). Without a recording the tasks do not
+     * read the clock. Recordings may overlap, the activity is recorded until the last one ends.
+     */
+    class recording {
+        thread_pool *m_pool;
+
+    public:
+        /**
+         * @param pool Pool to record, nullptr records nothing
+         */
+        explicit recording(thread_pool *pool) : m_pool{pool} {
+            if (m_pool != nullptr) m_pool->m_recordings.fetch_add(1);
+        }
+
+        ~recording() {
+            if (m_pool != nullptr) m_pool->m_recordings.fetch_sub(1);
+        }
+
+        recording(recording const &) = delete;
+        recording &operator=(recording const &) = delete;
+    };
+
+    /**
+     * Starts the worker threads
+     * @param thread_count Number of workers, zero means default_thread_count()
+     */
+    explicit thread_pool(std::size_t thread_count = 0);
+    ~thread_pool();
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    inline std::size_t size() const { return m_threads.size(); }
+
+    /**
+     * @return Number of hardware threads, at least one
+     */
+    static std::size_t default_thread_count();
+
+    /**
+     * Returns the process-wide pool used by the parallel graph algorithms.
+     * It is created on first use with the size set by set_global_thread_count().
+     */
+    static thread_pool &global();
+
+    /**
+     * Returns the number of tasks executed and the time spent executing them, one entry per worker and
+     * one more for all threads outside of the pool. The chunk of a parallel_for run directly by the calling
+     * thread counts as its work as well. Only work done during a recording is counted. The counters only grow,
+     * so subtract two snapshots to measure a phase.
+     */
+    std::vector<worker_activity> activity() const;
+
+    /**
+     * Sets the size of the global pool. Has no effect once global() has been called.
+     * @param thread_count Number of workers, zero means default_thread_count()
+     */
+    static void set_global_thread_count(std::size_t thread_count);
+
+    /**
+     * Queues a task. Called from a worker, the task goes to the back of its own deque.
+     * Called from elsewhere, the deques are filled round-robin.
+     * @param task Task to execute
+     */
+    void submit(task_t task);
+
+    /**
+     * Calls body(chunk_begin, chunk_end) for chunks covering [begin, end) and waits until all of them finish.
+     * The first exception thrown by the body is rethrown in the calling thread.
+     * @param begin Start of the range
+     * @param end End of the range (exclusive)
+     * @param grain Maximal chunk length, zero picks one giving about eight chunks per worker
+     * @param body Callable taking (std::size_t, std::size_t)
+     */
+    template<typename Body>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Body const &body) {
+        if (begin >= end) return;
+
+        if (grain == 0) grain = std::max<std::size_t>(1, (end - begin) / (8 * std::max<std::size_t>(1, size())));
+
+        if (end - begin <= grain || size() == 0) {
+            body(begin, end);
+            return;
+        }
+
+        std::atomic<std::size_t> remaining{1};
+        std::exception_ptr error{};
+        std::mutex error_mutex;
+
+        auto recorded = m_recordings.load(std::memory_order_relaxed) > 0;
+        auto started = recorded ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        split_range(begin, end, grain, body, remaining, error, error_mutex);
+        if (recorded) record_inline(started);
+
+        help_while(remaining);
+
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+/**
+ * Calls body(i) for every i in [0, count), one task per index, on the pool if there is one
+ * and in the calling thread otherwise. Meant for work which is already split into a few large blocks.
+ * @param pool Pool or nullptr
+ * @param count Number of tasks
+ * @param body Callable taking std::size_t
+ */
+template<typename Body>
+void for_each_task(thread_pool *pool, std::size_t count, Body const &body) {
+    if (pool == nullptr || count == 1) {
+        for (std::size_t i = 0; i < count; i++) body(i);
+        return;
+    }
+
+    pool->parallel_for(0, count, 1, [&body](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; i++) body(i);
+    });
+}
+
+#endif //MINIMUM_SPANNING_TREE_THREAD_POOL_H
@@ -0,0 +1,96 @@
+#ifndef MINIMUM_SPANNING_TREE_UNION_FIND_H
+#define MINIMUM_SPANNING_TREE_UNION_FIND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "arena.h"
+
+/**
+ * Disjoint-set forest over dense ids 0..n-1 with path halving and union by size.
+ * Both operations run in amortized inverse-Ackermann time.
+ * @tparam Allocator Allocator of the ids, e.g. an arena_allocator for scratch forests
+ */
+template<typename Allocator = std::allocator<std::uint32_t>>
+class basic_union_find {
+public:
+    typedef std::uint32_t id_t;
+
+private:
+    std::vector<id_t, Allocator> m_parent;
+    std::vector<id_t, Allocator> m_size;
+    std::size_t m_set_count;
+
+public:
+    explicit basic_union_find(std::size_t n, Allocator const &allocator = Allocator())
+            : m_parent(n, allocator), m_size(n, 1, allocator), m_set_count{n} {
+        std::iota(m_parent.begin(), m_parent.end(), id_t{0});
+    }
+
+    /**
+     * Makes every element of 0..n-1 a set of its own again. Reuses the memory if n does not exceed
+     * the size the forest was created with.
+     * @param n Number of elements
+     */
+    void reset(std::size_t n) {
+        m_parent.resize(n);
+        m_size.assign(n, 1);
+        m_set_count = n;
+        std::iota(m_parent.begin(), m_parent.end(), id_t{0});
+    }
+
+    inline std::size_t size() const { return m_parent.size(); }
+    inline std::size_t set_count() const { return m_set_count; }
+
+    /**
+     * Finds the representative of the set containing x. Every visited node is pointed to its grandparent,
+     * which halves the path length for subsequent queries.
+     * @param x Element
+     * @return Representative of the set
+     */
+    inline id_t find(id_t x) {
+        while (m_parent[x] != x) {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+
+    /**
+     * Finds the representative of the set containing x without modifying the forest,
+     * so any number of threads may call it concurrently as long as no thread merges sets.
+     * Union by size keeps the trees O(log n) deep.
+     * @param x Element
+     * @return Representative of the set
+     */
+    inline id_t find_root(id_t x) const {
+        while (m_parent[x] != x) x = m_parent[x];
+        return x;
+    }
+
+    /**
+     * Merges the sets containing a and b, attaching the smaller tree under the larger one.
+     * @return False if a and b were already in the same set
+     */
+    inline bool unite(id_t a, id_t b) {
+        a = find(a);
+        b = find(b);
+
+        if (a == b) return false;
+        if (m_size[a] < m_size[b]) std::swap(a, b);
+
+        m_parent[b] = a;
+        m_size[a] += m_size[b];
+        --m_set_count;
+
+        return true;
+    }
+};
+
+typedef basic_union_find<> union_find;
+typedef basic_union_find<arena_allocator<std::uint32_t>> arena_union_find;
+
+#endif //MINIMUM_SPANNING_TREE_UNION_FIND_H